@@ -0,0 +1,152 @@
+﻿#include "BaselineComparison.h"
+
+#include <fstream>
+#include <iomanip>
+#include <map>
+
+#include "Statistics.h"
+
+// Reads "key": value from one line of google-benchmark's pretty printed JSON.
+static bool ParseJsonField(const std::string& line, std::string& key, std::string& value)
+{
+	const size_t keyBegin = line.find('"');
+	const size_t keyEnd = keyBegin == std::string::npos ? std::string::npos : line.find('"', keyBegin + 1);
+	const size_t colon = keyEnd == std::string::npos ? std::string::npos : line.find(':', keyEnd);
+	if (colon == std::string::npos)
+		return false;
+	key = line.substr(keyBegin + 1, keyEnd - keyBegin - 1);
+
+	value = line.substr(colon + 1);
+	value.erase(0, value.find_first_not_of(" \t"));
+	while (!value.empty() && (value.back() == ',' || value.back() == '\r' || value.back() == ' '))
+		value.pop_back();
+	if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+	{
+		std::string unescaped;
+		for (size_t i = 1; i + 1 < value.size(); ++i)
+		{
+			if (value[i] == '\\' && i + 2 < value.size())
+				++i;
+			unescaped += value[i];
+		}
+		value = unescaped;
+	}
+	return true;
+}
+
+static double TimeUnitToNs(const std::string& unit)
+{
+	if (unit == "us")
+		return 1.0e3;
+	if (unit == "ms")
+		return 1.0e6;
+	if (unit == "s")
+		return 1.0e9;
+	return 1.0;
+}
+
+bool LoadBaseline(const std::string& path, BaselineRun& baseline, std::string& error)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		error = "cannot open " + path;
+		return false;
+	}
+
+	bool inFingerprint = false;
+	BenchmarkResult current;
+	std::string timeUnit = "ns";
+	double realTime = 0.0;
+	for (std::string line; std::getline(file, line);)
+	{
+		std::string key, value;
+		if (line.find("\"fingerprint\"") != std::string::npos)
+		{
+			inFingerprint = true;
+			continue;
+		}
+		if (inFingerprint)
+		{
+			if (line.find('}') != std::string::npos)
+				inFingerprint = false;
+			else if (ParseJsonField(line, key, value))
+				baseline.fingerprint.emplace_back(key, value);
+			continue;
+		}
+
+		// every benchmark entry starts with "name" and is closed by "}"
+		if (ParseJsonField(line, key, value))
+		{
+			if (key == "name")
+			{
+				ParseBenchmarkName(value, current);
+				realTime = 0.0;
+				timeUnit = "ns";
+			}
+			else if (key == "real_time")
+				realTime = std::atof(value.c_str());
+			else if (key == "time_unit")
+				timeUnit = value;
+			else if (key == "run_type" && value == "aggregate")
+				current.name.clear();
+		}
+		else if (line.find('}') != std::string::npos && !current.name.empty())
+		{
+			if (!IsAggregateName(current.name))
+			{
+				current.realTimeNs = realTime * TimeUnitToNs(timeUnit);
+				baseline.results.push_back(current);
+			}
+			current.name.clear();
+		}
+	}
+
+	if (baseline.fingerprint.empty())
+	{
+		error = path + " has no fingerprint, it was not written by this driver";
+		return false;
+	}
+	return true;
+}
+
+bool PrintBaselineComparison(std::ostream& out, const BaselineRun& baseline, const Fingerprint& current,
+	const std::vector<BenchmarkResult>& results, bool allowMismatch)
+{
+	const auto mismatches = FingerprintMismatches(baseline.fingerprint, current);
+	if (!mismatches.empty())
+	{
+		out << "\nFingerprint mismatch between baseline and current run:\n";
+		for (const auto& mismatch : mismatches)
+			out << "  " << mismatch << '\n';
+		if (!allowMismatch)
+		{
+			out << "refusing to compare, pass --allow_fingerprint_mismatch to override\n";
+			return false;
+		}
+		out << "comparing anyway (--allow_fingerprint_mismatch)\n";
+	}
+
+	// repetitions are collapsed to their median on both sides
+	std::map<std::string, std::vector<double>> before, after;
+	for (const auto& r : baseline.results)
+		before[r.name].push_back(r.realTimeNs);
+	for (const auto& r : results)
+		after[r.name].push_back(r.realTimeNs);
+
+	out << "\nComparison with baseline (time ratio current / baseline, < 1 is faster)\n";
+	out << std::left << std::setw(44) << "benchmark" << std::right << std::setw(14) << "baseline ns"
+		<< std::setw(14) << "current ns" << std::setw(9) << "ratio" << '\n';
+	out << std::fixed << std::setprecision(1);
+	for (const auto& entry : after)
+	{
+		const auto base = before.find(entry.first);
+		if (base == before.end())
+			continue;
+		const double b = Median(base->second), c = Median(entry.second);
+		out << std::left << std::setw(44) << entry.first << std::right << std::setw(14) << b << std::setw(14) << c
+			<< std::setprecision(3) << std::setw(9) << (b > 0.0 ? c / b : 0.0) << std::setprecision(1) << '\n';
+	}
+	out.unsetf(std::ios::floatfield);
+	return true;
+}
@@ -0,0 +1,24 @@
+﻿#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "BenchmarkResults.h"
+#include "EnvironmentInfo.h"
+
+// Results and fingerprint read back from a JSON file written by the driver
+// (--benchmark_out=<file>).
+struct BaselineRun
+{
+	Fingerprint fingerprint;
+	std::vector<BenchmarkResult> results;
+};
+
+bool LoadBaseline(const std::string& path, BaselineRun& baseline, std::string& error);
+
+// Prints baseline vs current time per benchmark. Refuses (prints the differing
+// fingerprint fields and returns false) when the runs come from different machines or
+// builds, unless allowMismatch is set.
+bool PrintBaselineComparison(std::ostream& out, const BaselineRun& baseline, const Fingerprint& current,
+	const std::vector<BenchmarkResult>& results, bool allowMismatch);
@@ -0,0 +1,381 @@
+﻿#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tbb/global_control.h"
+
+#include "benchmark/benchmark.h"
+
+#include "BaselineComparison.h"
+#include "BenchmarkResults.h"
+#include "EnvironmentInfo.h"
+#include "ImplementationReport.h"
+#include "ScalingReport.h"
+#include "SimdReport.h"
+#include "Statistics.h"
+
+// Replacement for BENCHMARK_MAIN() that understands a few extra flags on top of the
+// google-benchmark ones:
+//
+//	--threads=1,2,4,8         run the whole suite once per TBB worker limit
+//	--scaling_report          print speedup / efficiency / Amdahl fit at the end
+//	                          (implies --threads=1,2,4,...,hardware_concurrency)
+//	--min_efficiency=0.5      efficiency threshold for the "max useful threads" column
+//	--simd_report             print the SIMD / threads split of the novec_* builds
+//	--impl_report             print per-kernel tables comparing std_*, pstl_* and
+//	                          threads_* registrations
+//
+//	--ci_target=0.02          statistical rigor mode: repeat every benchmark until the
+//	                          95% CI of the median is within +-2% of the median
+//	--min_samples=5           repetitions per round in rigor mode
+//	--max_samples=50          give up on a benchmark after this many repetitions
+//	--outlier_threshold=3     reject samples further than this many scaled MADs
+//	                          from the median
+//
+//	--compare_with=base.json  compare against a file written with --benchmark_out;
+//	                          refused when the environment fingerprints differ
+//	--threads=1,2 --compare_with=base.json
+//	                          compare every worker limit with its own file of a sweep
+//	                          written with --threads=1,2 --benchmark_out=base.json,
+//	                          i.e. base_t1.json and base_t2.json
+//	--allow_fingerprint_mismatch
+//	                          compare anyway, listing the differences
+//
+// JSON --benchmark_out is written by the driver rather than google-benchmark, so it
+// survives several passes (one file per worker limit, suffixed _t<threads>) and
+// carries the environment fingerprint in its "context".
+//
+// The worker limit is applied with tbb::global_control, so it constrains pstl and
+// libstdc++'s std::execution. MSVC's std::execution uses the Windows thread pool and
+// ignores it.
+struct DriverOptions
+{
+	std::vector<int> threads;
+	bool scalingReport = false;
+	double minEfficiency = 0.5;
+	bool simdReport = false;
+	bool implReport = false;
+
+	double ciTarget = 0.0; // 0 = rigor mode off
+	int minSamples = 5;
+	int maxSamples = 50;
+	double outlierThreshold = 3.0;
+
+	std::string out;
+	std::string outFormat = "json";
+	std::string compareWith;
+	bool allowFingerprintMismatch = false;
+
+	const char* argv0 = "";
+	std::string filter = ".";
+};
+
+static bool ParseFlag(const char* arg, const char* flag, const char** value)
+{
+	const size_t len = std::strlen(flag);
+	if (std::strncmp(arg, flag, len) != 0)
+		return false;
+	if (arg[len] == '\0')
+	{
+		*value = nullptr;
+		return true;
+	}
+	if (arg[len] != '=')
+		return false;
+	*value = arg + len + 1;
+	return true;
+}
+
+static std::vector<int> ParseIntList(const char* value)
+{
+	std::vector<int> list;
+	std::istringstream stream(value);
+	for (std::string item; std::getline(stream, item, ',');)
+		list.push_back(std::atoi(item.c_str()));
+	return list;
+}
+
+static std::vector<int> DefaultThreadCounts()
+{
+	const int hw = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+	std::vector<int> counts;
+	for (int p = 1; p < hw; p *= 2)
+		counts.push_back(p);
+	counts.push_back(hw);
+	return counts;
+}
+
+// Removes the driver flags from argv, leaving the rest for benchmark::Initialize.
+static DriverOptions ParseDriverOptions(int* argc, char** argv)
+{
+	DriverOptions options;
+	options.argv0 = argv[0];
+	int kept = 1;
+	char* outArgs[2] = { nullptr, nullptr };
+	for (int i = 1; i < *argc; ++i)
+	{
+		const char* value = nullptr;
+		if (ParseFlag(argv[i], "--threads", &value) && value)
+			options.threads = ParseIntList(value);
+		else if (ParseFlag(argv[i], "--scaling_report", &value))
+			options.scalingReport = true;
+		else if (ParseFlag(argv[i], "--min_efficiency", &value) && value)
+			options.minEfficiency = std::atof(value);
+		else if (ParseFlag(argv[i], "--simd_report", &value))
+			options.simdReport = true;
+		else if (ParseFlag(argv[i], "--impl_report", &value))
+			options.implReport = true;
+		else if (ParseFlag(argv[i], "--ci_target", &value) && value)
+			options.ciTarget = std::atof(value);
+		else if (ParseFlag(argv[i], "--min_samples", &value) && value)
+			options.minSamples = std::max(2, std::atoi(value));
+		else if (ParseFlag(argv[i], "--max_samples", &value) && value)
+			options.maxSamples = std::atoi(value);
+		else if (ParseFlag(argv[i], "--outlier_threshold", &value) && value)
+			options.outlierThreshold = std::atof(value);
+		else if (ParseFlag(argv[i], "--compare_with", &value) && value)
+			options.compareWith = value;
+		else if (ParseFlag(argv[i], "--allow_fingerprint_mismatch", &value))
+			options.allowFingerprintMismatch = true;
+		else if (ParseFlag(argv[i], "--benchmark_out", &value) && value)
+		{
+			options.out = value;
+			outArgs[0] = argv[i];
+		}
+		else if (ParseFlag(argv[i], "--benchmark_out_format", &value) && value)
+		{
+			options.outFormat = value;
+			outArgs[1] = argv[i];
+		}
+		else
+		{
+			// kept for google-benchmark, but rigor mode needs to restore it between rounds
+			if (ParseFlag(argv[i], "--benchmark_filter", &value) && value)
+				options.filter = value;
+			argv[kept++] = argv[i];
+		}
+	}
+	// console / csv files are left to google-benchmark
+	if (options.outFormat != "json")
+	{
+		for (char* arg : outArgs)
+			if (arg)
+				argv[kept++] = arg;
+		options.out.clear();
+	}
+	*argc = kept;
+
+	if (options.scalingReport && options.threads.empty())
+		options.threads = DefaultThreadCounts();
+	return options;
+}
+
+// Re-parses the given google-benchmark flags; flags not listed keep their values.
+static void SetBenchmarkFlags(const DriverOptions& options, std::vector<std::string> flags)
+{
+	std::vector<char*> argv{ const_cast<char*>(options.argv0) };
+	for (auto& flag : flags)
+		argv.push_back(&flag[0]);
+	int argc = static_cast<int>(argv.size());
+	benchmark::Initialize(&argc, argv.data());
+}
+
+static std::string EscapeRegex(const std::string& text)
+{
+	std::string escaped;
+	for (char c : text)
+	{
+		if (std::strchr(".^$|()[]{}*+?\\", c))
+			escaped += '\\';
+		escaped += c;
+	}
+	return escaped;
+}
+
+// Runs the filtered benchmarks in rounds of minSamples repetitions, re-running only
+// the ones whose median CI is still wider than the target. Returns one result per
+// benchmark with the time replaced by the median of the kept samples.
+static std::vector<BenchmarkResult> RunWithRigor(const DriverOptions& options, ResultCollector& collector, int threads,
+	std::vector<std::pair<std::string, SampleSummary>>& summaries)
+{
+	const size_t firstResult = collector.Results().size();
+	std::string filter = options.filter;
+	std::map<std::string, SampleSummary> summaryByName;
+
+	for (;;)
+	{
+		SetBenchmarkFlags(options, { "--benchmark_filter=" + filter,
+			"--benchmark_repetitions=" + std::to_string(options.minSamples) });
+		benchmark::RunSpecifiedBenchmarks(&collector);
+
+		std::map<std::string, std::vector<double>> samples;
+		const auto& results = collector.Results();
+		for (size_t i = firstResult; i < results.size(); ++i)
+			samples[results[i].name].push_back(results[i].realTimeNs);
+
+		std::string pending;
+		for (const auto& entry : samples)
+		{
+			const SampleSummary summary = Summarize(entry.second, options.outlierThreshold);
+			summaryByName[entry.first] = summary;
+			if (!summary.Converged(options.ciTarget) && static_cast<int>(entry.second.size()) < options.maxSamples)
+				pending += (pending.empty() ? "" : "|") + EscapeRegex(entry.first);
+		}
+		if (pending.empty())
+			break;
+		filter = "^(" + pending + ")$";
+	}
+	SetBenchmarkFlags(options, { "--benchmark_filter=" + options.filter, "--benchmark_repetitions=1" });
+
+	std::vector<BenchmarkResult> medians;
+	const auto& results = collector.Results();
+	for (size_t i = results.size(); i-- > firstResult;)
+	{
+		const auto it = summaryByName.find(results[i].name);
+		if (it == summaryByName.end())
+			continue; // already taken from a later round
+		BenchmarkResult median = results[i];
+		median.realTimeNs = it->second.median;
+		median.threads = threads;
+		medians.push_back(median);
+		summaries.emplace_back(results[i].name + (threads > 0 ? " @" + std::to_string(threads) : ""), it->second);
+		summaryByName.erase(it);
+	}
+	std::reverse(medians.begin(), medians.end());
+	return medians;
+}
+
+// base.json -> base_t4.json
+static std::string OutputPathForThreads(const std::string& path, int threads)
+{
+	if (threads <= 0)
+		return path;
+	const size_t slash = path.find_last_of("/\\");
+	const size_t dot = path.find_last_of('.');
+	const size_t insertAt = (dot == std::string::npos || (slash != std::string::npos && dot < slash)) ? path.size() : dot;
+	return path.substr(0, insertAt) + "_t" + std::to_string(threads) + path.substr(insertAt);
+}
+
+static void PrintRigorReport(std::ostream& out, const DriverOptions& options,
+	std::vector<std::pair<std::string, SampleSummary>> summaries)
+{
+	std::sort(summaries.begin(), summaries.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+	out << "\nStatistical summary (median of kept samples, 95% CI of the median, target +-"
+		<< options.ciTarget * 100.0 << "%)\n";
+	out << std::left << std::setw(44) << "benchmark" << std::right << std::setw(14) << "median ns"
+		<< std::setw(14) << "ci low" << std::setw(14) << "ci high" << std::setw(9) << "+-%"
+		<< std::setw(8) << "cv%" << std::setw(7) << "n" << std::setw(9) << "outliers" << "\n";
+	out << std::fixed << std::setprecision(1);
+	for (const auto& entry : summaries)
+	{
+		const SampleSummary& s = entry.second;
+		out << std::left << std::setw(44) << entry.first << std::right << std::setw(14) << s.median
+			<< std::setw(14) << s.ciLow << std::setw(14) << s.ciHigh
+			<< std::setw(9) << s.RelativeHalfWidth() * 100.0 << std::setw(8) << s.cv * 100.0
+			<< std::setw(7) << s.count << std::setw(9) << s.outliers
+			<< (s.Converged(options.ciTarget) ? "" : "  (not converged)") << "\n";
+	}
+	out.unsetf(std::ios::floatfield);
+}
+
+int main(int argc, char** argv)
+{
+	DriverOptions options = ParseDriverOptions(&argc, argv);
+
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv))
+		return 1;
+
+	// one baseline per pass, named like the --benchmark_out files of a sweep, so every
+	// worker limit is compared with the same limit (the fingerprints include it)
+	std::map<int, BaselineRun> baselines;
+	const std::vector<int> threadCounts = options.threads.empty() ? std::vector<int>{ 0 } : options.threads;
+	if (!options.compareWith.empty())
+	{
+		for (int threads : threadCounts)
+		{
+			std::string error;
+			if (!LoadBaseline(OutputPathForThreads(options.compareWith, threads), baselines[threads], error))
+			{
+				std::cerr << "--compare_with: " << error << "\n";
+				return 1;
+			}
+		}
+	}
+
+	const bool rigor = options.ciTarget > 0.0;
+	bool comparisonRefused = false;
+	ResultCollector collector;
+	std::vector<BenchmarkResult> medians;
+	std::vector<std::pair<std::string, SampleSummary>> summaries;
+
+	for (int threads : threadCounts)
+	{
+		std::unique_ptr<tbb::global_control> limit;
+		if (threads > 0)
+		{
+			std::cout << "\n--- " << threads << " thread(s) ---\n";
+			limit = std::make_unique<tbb::global_control>(tbb::global_control::max_allowed_parallelism, static_cast<size_t>(threads));
+		}
+		collector.SetThreads(threads);
+
+		const Fingerprint fingerprint = CollectFingerprint(threads);
+		std::ofstream outFile;
+		std::unique_ptr<FingerprintJSONReporter> fileReporter;
+		if (!options.out.empty())
+		{
+			const std::string path = OutputPathForThreads(options.out, threads);
+			outFile.open(path);
+			if (!outFile)
+			{
+				std::cerr << "cannot open " << path << " for writing\n";
+				return 1;
+			}
+			fileReporter = std::make_unique<FingerprintJSONReporter>(fingerprint);
+			fileReporter->SetOutputStream(&outFile);
+			fileReporter->SetErrorStream(&std::cerr);
+		}
+		collector.SetFileReporter(fileReporter.get());
+
+		const size_t firstResult = collector.Results().size();
+		std::vector<BenchmarkResult> passResults;
+		if (rigor)
+		{
+			passResults = RunWithRigor(options, collector, threads, summaries);
+			medians.insert(medians.end(), passResults.begin(), passResults.end());
+		}
+		else
+		{
+			benchmark::RunSpecifiedBenchmarks(&collector);
+			passResults.assign(collector.Results().begin() + firstResult, collector.Results().end());
+		}
+
+		collector.SetFileReporter(nullptr);
+		if (fileReporter)
+			fileReporter->Finalize();
+
+		if (!options.compareWith.empty()
+			&& !PrintBaselineComparison(std::cout, baselines[threads], fingerprint, passResults, options.allowFingerprintMismatch))
+			comparisonRefused = true;
+	}
+
+	if (rigor)
+		PrintRigorReport(std::cout, options, summaries);
+	if (options.scalingReport)
+		PrintScalingReport(std::cout, rigor ? medians : collector.Results(), options.minEfficiency);
+	if (options.simdReport)
+		PrintSimdReport(std::cout, rigor ? medians : collector.Results());
+	if (options.implReport)
+		PrintImplementationReport(std::cout, rigor ? medians : collector.Results());
+	return comparisonRefused ? 2 : 0;
+}
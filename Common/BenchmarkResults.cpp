@@ -0,0 +1,97 @@
+﻿#include "BenchmarkResults.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+// benchmark_name is a data member up to google-benchmark 1.4 and a method afterwards
+template <typename Run>
+static auto RunName(const Run& run, int) -> decltype(run.benchmark_name())
+{
+	return run.benchmark_name();
+}
+
+template <typename Run>
+static std::string RunName(const Run& run, long)
+{
+	return run.benchmark_name;
+}
+
+static bool IsNumber(const std::string& s)
+{
+	return !s.empty() && std::all_of(s.begin(), s.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; });
+}
+
+bool IsAggregateName(const std::string& name)
+{
+	for (const char* suffix : { "_mean", "_median", "_stddev", "_cv" })
+	{
+		const std::string s(suffix);
+		if (name.size() > s.size() && name.compare(name.size() - s.size(), s.size(), s) == 0)
+			return true;
+	}
+	return false;
+}
+
+void ParseBenchmarkName(const std::string& name, BenchmarkResult& result)
+{
+	std::vector<std::string> parts;
+	std::istringstream stream(name);
+	for (std::string part; std::getline(stream, part, '/');)
+		parts.push_back(part);
+
+	result.name = name;
+	result.kernel = parts.empty() ? name : parts.front();
+	result.policy.clear();
+	result.size = 0;
+	for (size_t i = 1; i < parts.size(); ++i)
+	{
+		if (IsNumber(parts[i]))
+		{
+			result.size = std::stoll(parts[i]);
+			break;
+		}
+		if (i == 1)
+			result.policy = parts[i];
+	}
+}
+
+void ResultCollector::SetFileReporter(benchmark::BenchmarkReporter* reporter)
+{
+	fileReporter_ = reporter;
+	fileContextWritten_ = false;
+}
+
+bool ResultCollector::ReportContext(const Context& context)
+{
+	if (fileReporter_ && !fileContextWritten_)
+	{
+		fileReporter_->ReportContext(context);
+		fileContextWritten_ = true;
+	}
+	return ConsoleReporter::ReportContext(context);
+}
+
+void ResultCollector::ReportRuns(const std::vector<Run>& reports)
+{
+	for (const auto& run : reports)
+	{
+		const std::string name = RunName(run, 0);
+		if (run.error_occurred || IsAggregateName(name))
+			continue;
+
+		BenchmarkResult result;
+		ParseBenchmarkName(name, result);
+		const double toNs = 1.0e9 / benchmark::GetTimeUnitMultiplier(run.time_unit);
+		result.threads = threads_;
+		result.realTimeNs = run.GetAdjustedRealTime() * toNs;
+		result.cpuTimeNs = run.GetAdjustedCPUTime() * toNs;
+		result.iterations = static_cast<int64_t>(run.iterations);
+		for (const auto& counter : run.counters)
+			result.counters[counter.first] = counter.second.value;
+		results_.push_back(std::move(result));
+	}
+	if (fileReporter_)
+		fileReporter_->ReportRuns(reports);
+	ConsoleReporter::ReportRuns(reports);
+}
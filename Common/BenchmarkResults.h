@@ -0,0 +1,52 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+// One reported run, split into the parts of the "BM_Kernel/policy/N" naming used by
+// the BENCHMARK_CAPTURE registrations.
+struct BenchmarkResult
+{
+	std::string name;   // full benchmark name
+	std::string kernel; // BM_Kernel
+	std::string policy; // pstl_par, std_seq, ... (empty if not captured)
+	int64_t size = 0;   // first numeric argument
+	int threads = 0;    // worker limit the run was made with, 0 = unlimited
+	double realTimeNs = 0.0;
+	double cpuTimeNs = 0.0;
+	int64_t iterations = 0;
+	std::map<std::string, double> counters;
+};
+
+// Splits a benchmark name into kernel / policy / size.
+void ParseBenchmarkName(const std::string& name, BenchmarkResult& result);
+
+// True for the _mean / _median / _stddev / _cv rows added for repetitions.
+bool IsAggregateName(const std::string& name);
+
+// Console reporter that also keeps every non-aggregate run, so the main driver can
+// post-process the numbers once all benchmarks finished. Runs are also forwarded to an
+// optional file reporter, which unlike google-benchmark's own --benchmark_out stays
+// open across several RunSpecifiedBenchmarks calls.
+class ResultCollector : public benchmark::ConsoleReporter
+{
+public:
+	void SetThreads(int threads) { threads_ = threads; }
+	const std::vector<BenchmarkResult>& Results() const { return results_; }
+
+	// the reporter's context is written on the next ReportContext, Finalize is up to the caller
+	void SetFileReporter(benchmark::BenchmarkReporter* reporter);
+
+	bool ReportContext(const Context& context) override;
+	void ReportRuns(const std::vector<Run>& reports) override;
+
+private:
+	int threads_ = 0;
+	std::vector<BenchmarkResult> results_;
+	benchmark::BenchmarkReporter* fileReporter_ = nullptr;
+	bool fileContextWritten_ = false;
+};
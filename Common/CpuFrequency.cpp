@@ -0,0 +1,142 @@
+﻿#include "CpuFrequency.h"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <powrprof.h>
+#pragma comment(lib, "PowrProf.lib")
+
+// not declared by the SDK headers, layout documented for CallNtPowerInformation
+struct PROCESSOR_POWER_INFORMATION
+{
+	ULONG Number;
+	ULONG MaxMhz;
+	ULONG CurrentMhz;
+	ULONG MhzLimit;
+	ULONG MaxIdleState;
+	ULONG CurrentIdleState;
+};
+
+static std::vector<PROCESSOR_POWER_INFORMATION> QueryPowerInformation()
+{
+	SYSTEM_INFO sysInfo;
+	GetSystemInfo(&sysInfo);
+	std::vector<PROCESSOR_POWER_INFORMATION> info(sysInfo.dwNumberOfProcessors);
+	const auto bytes = static_cast<ULONG>(info.size() * sizeof(PROCESSOR_POWER_INFORMATION));
+	if (CallNtPowerInformation(ProcessorInformation, nullptr, 0, info.data(), bytes) != 0)
+		info.clear();
+	return info;
+}
+
+std::vector<double> ReadCoreFrequenciesMHz()
+{
+	std::vector<double> freqs;
+	for (const auto& cpu : QueryPowerInformation())
+	{
+		// CurrentMhz is capped by MhzLimit when the firmware throttles
+		freqs.push_back(static_cast<double>(std::min(cpu.CurrentMhz, cpu.MhzLimit)));
+	}
+	return freqs;
+}
+
+double ReadBaseFrequencyMHz()
+{
+	const auto info = QueryPowerInformation();
+	return info.empty() ? 0.0 : static_cast<double>(info.front().MaxMhz);
+}
+
+#else
+
+static bool ReadSysfsValue(const std::string& path, double& value)
+{
+	std::ifstream file(path);
+	return static_cast<bool>(file >> value);
+}
+
+std::vector<double> ReadCoreFrequenciesMHz()
+{
+	std::vector<double> freqs;
+	const unsigned int cpuCount = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned int cpu = 0; cpu < cpuCount; ++cpu)
+	{
+		double kHz = 0.0;
+		if (ReadSysfsValue("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_cur_freq", kHz))
+			freqs.push_back(kHz / 1000.0);
+	}
+	return freqs;
+}
+
+double ReadBaseFrequencyMHz()
+{
+	double kHz = 0.0;
+	if (ReadSysfsValue("/sys/devices/system/cpu/cpu0/cpufreq/base_frequency", kHz) ||
+		ReadSysfsValue("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_base_freq", kHz))
+		return kHz / 1000.0;
+	return 0.0;
+}
+
+#endif
+
+CpuFrequencyMonitor::CpuFrequencyMonitor(benchmark::State& state, std::chrono::milliseconds interval)
+	: state_(state)
+	, interval_(interval)
+	, start_(std::chrono::steady_clock::now())
+{
+	Sample();
+	sampler_ = std::thread([this]() { Run(); });
+}
+
+CpuFrequencyMonitor::~CpuFrequencyMonitor()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	wake_.notify_one();
+	sampler_.join();
+	Sample();
+
+	if (samplesMHz_.empty())
+		return; // no frequency source on this machine, leave the report untouched
+
+	// the constructor's sample is taken before the work ramped the clocks up, keep it
+	// only when the run was too short for any other
+	if (samplesMHz_.size() > 1)
+		samplesMHz_.erase(samplesMHz_.begin());
+
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+	const double avgMHz = std::accumulate(samplesMHz_.begin(), samplesMHz_.end(), 0.0) / samplesMHz_.size();
+	const auto minMax = std::minmax_element(samplesMHz_.begin(), samplesMHz_.end());
+	const double baseMHz = ReadBaseFrequencyMHz();
+
+	const bool dropped = *minMax.first < (1.0 - DropTolerance) * *minMax.second;
+	const bool belowBase = baseMHz > 0.0 && avgMHz < (1.0 - DropTolerance) * baseMHz;
+
+	state_.counters["GHz"] = avgMHz / 1000.0;
+	state_.counters["GHz_min"] = *minMax.first / 1000.0;
+	state_.counters["throttled"] = (dropped || belowBase) ? 1.0 : 0.0;
+	if (state_.iterations() > 0)
+		state_.counters["cycles"] = avgMHz * 1.0e6 * seconds / static_cast<double>(state_.iterations());
+}
+
+void CpuFrequencyMonitor::Sample()
+{
+	// the fastest core rather than the mean: in a seq run the idle cores would pull the
+	// mean down, while the cores doing the work all run at about the highest clock
+	const auto freqs = ReadCoreFrequenciesMHz();
+	if (!freqs.empty())
+		samplesMHz_.push_back(*std::max_element(freqs.begin(), freqs.end()));
+}
+
+void CpuFrequencyMonitor::Run()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (!wake_.wait_for(lock, interval_, [this]() { return stop_; }))
+		Sample();
+}
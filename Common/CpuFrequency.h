@@ -0,0 +1,59 @@
+﻿#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+// Per-core clock reading in MHz, empty when the platform does not expose it.
+std::vector<double> ReadCoreFrequenciesMHz();
+
+// Nominal (non-turbo) clock in MHz, or 0 if unknown.
+double ReadBaseFrequencyMHz();
+
+// Samples the core clocks on a background thread while a benchmark runs, so seq
+// (single core, full turbo) and par (all cores, thermally limited) results can be
+// compared in cycles rather than in wall time.
+//
+// Put it in front of the timed loop:
+//
+//	CpuFrequencyMonitor frequencyMonitor(state);
+//	for (auto _ : state) { ... }
+//
+// and on destruction it adds the counters:
+//	GHz        - average over the run of the fastest core's clock, i.e. of the cores
+//	             doing the work, idle cores clock down
+//	GHz_min    - lowest sample
+//	cycles     - estimated cycles per iteration (time * GHz)
+//	throttled  - 1 when the clock dropped by more than DropTolerance during the run,
+//	             or fell below the nominal base frequency
+class CpuFrequencyMonitor
+{
+public:
+	static constexpr double DropTolerance = 0.10;
+
+	explicit CpuFrequencyMonitor(benchmark::State& state, std::chrono::milliseconds interval = std::chrono::milliseconds(10));
+	~CpuFrequencyMonitor();
+
+	CpuFrequencyMonitor(const CpuFrequencyMonitor&) = delete;
+	CpuFrequencyMonitor& operator=(const CpuFrequencyMonitor&) = delete;
+
+private:
+	void Sample();
+	void Run();
+
+	benchmark::State& state_;
+	const std::chrono::milliseconds interval_;
+	const std::chrono::steady_clock::time_point start_;
+
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	bool stop_ = false;
+
+	std::vector<double> samplesMHz_; // fastest core per sampling tick
+	std::thread sampler_;
+};
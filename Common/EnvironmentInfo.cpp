@@ -0,0 +1,309 @@
+﻿#include "EnvironmentInfo.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include <pstl/execution>
+
+#if __has_include("tbb/version.h")
+#include "tbb/version.h"
+#else
+#include "tbb/tbb_stddef.h"
+#endif
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <powrprof.h>
+#pragma comment(lib, "PowrProf.lib")
+#endif
+
+static std::string JsonEscape(const std::string& text)
+{
+	std::string escaped;
+	for (char c : text)
+	{
+		if (c == '"' || c == '\\')
+			escaped += '\\';
+		if (c != '\n' && c != '\r')
+			escaped += c;
+	}
+	return escaped;
+}
+
+static std::string CompilerName()
+{
+#if defined(__INTEL_COMPILER)
+	return "icc " + std::to_string(__INTEL_COMPILER) + "." + std::to_string(__INTEL_COMPILER_UPDATE);
+#elif defined(_MSC_VER)
+	return "msvc " + std::to_string(_MSC_FULL_VER);
+#elif defined(__clang__)
+	return "clang " __clang_version__;
+#elif defined(__GNUC__)
+	return "gcc " __VERSION__;
+#else
+	return "unknown";
+#endif
+}
+
+static std::string CompilerFlags()
+{
+#if defined(BENCHMARK_BUILD_FLAGS)
+	// passed by CMakeLists.txt
+	return BENCHMARK_BUILD_FLAGS;
+#else
+	std::string flags;
+#if defined(NDEBUG)
+	flags += "NDEBUG ";
+#else
+	flags += "DEBUG ";
+#endif
+#if defined(__AVX512F__)
+	flags += "AVX512F ";
+#endif
+#if defined(__AVX2__)
+	flags += "AVX2 ";
+#elif defined(__AVX__)
+	flags += "AVX ";
+#endif
+#if defined(__FAST_MATH__)
+	flags += "fast-math ";
+#endif
+	return flags;
+#endif
+}
+
+static std::string TbbVersion()
+{
+	return std::to_string(TBB_VERSION_MAJOR) + "." + std::to_string(TBB_VERSION_MINOR) +
+		" (interface " + std::to_string(TBB_INTERFACE_VERSION) + ")";
+}
+
+static std::string PstlVersion()
+{
+#if defined(PSTL_VERSION)
+	return std::to_string(PSTL_VERSION);
+#elif defined(__PSTL_VERSION)
+	return std::to_string(__PSTL_VERSION);
+#elif defined(_PSTL_VERSION)
+	return std::to_string(_PSTL_VERSION);
+#else
+	return "unknown";
+#endif
+}
+
+static std::string CacheSizes()
+{
+	std::ostringstream caches;
+	for (const auto& cache : benchmark::CPUInfo::Get().caches)
+	{
+		caches << (caches.tellp() > 0 ? ", " : "") << "L" << cache.level
+			<< (cache.type == "Data" ? "d" : cache.type == "Instruction" ? "i" : "")
+			<< " " << cache.size / 1024 << "K";
+		if (cache.num_sharing > 1)
+			caches << " x" << cache.num_sharing;
+	}
+	return caches.str();
+}
+
+struct CpuTopology
+{
+	std::string model = "unknown";
+	int cores = 0;
+	int sockets = 0;
+	std::string smt = "unknown";
+	std::string governor = "unknown";
+	std::string transparentHugePages = "n/a";
+};
+
+#ifdef _WIN32
+
+static CpuTopology ReadCpuTopology()
+{
+	CpuTopology topology;
+
+	char name[256] = {};
+	DWORD size = sizeof(name);
+	if (RegGetValueA(HKEY_LOCAL_MACHINE, "HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0",
+		"ProcessorNameString", RRF_RT_REG_SZ, nullptr, name, &size) == ERROR_SUCCESS)
+		topology.model = name;
+
+	DWORD bytes = 0;
+	GetLogicalProcessorInformation(nullptr, &bytes);
+	std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(bytes / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+	if (!info.empty() && GetLogicalProcessorInformation(info.data(), &bytes))
+	{
+		for (const auto& entry : info)
+		{
+			if (entry.Relationship == RelationProcessorCore)
+			{
+				++topology.cores;
+				if (entry.ProcessorCore.Flags == LTP_PC_SMT)
+					topology.smt = "on";
+			}
+			else if (entry.Relationship == RelationProcessorPackage)
+				++topology.sockets;
+		}
+		if (topology.smt != "on")
+			topology.smt = "off";
+	}
+
+	GUID* scheme = nullptr;
+	if (PowerGetActiveScheme(nullptr, &scheme) == ERROR_SUCCESS)
+	{
+		char guid[64];
+		std::snprintf(guid, sizeof(guid), "power scheme {%08lX-%04hX-%04hX-%02X%02X-%02X%02X%02X%02X%02X%02X}",
+			scheme->Data1, scheme->Data2, scheme->Data3, scheme->Data4[0], scheme->Data4[1], scheme->Data4[2],
+			scheme->Data4[3], scheme->Data4[4], scheme->Data4[5], scheme->Data4[6], scheme->Data4[7]);
+		topology.governor = guid;
+		LocalFree(scheme);
+	}
+	return topology;
+}
+
+#else
+
+static std::string ReadFirstLine(const std::string& path)
+{
+	std::ifstream file(path);
+	std::string line;
+	std::getline(file, line);
+	return line;
+}
+
+static CpuTopology ReadCpuTopology()
+{
+	CpuTopology topology;
+
+	std::set<std::pair<std::string, std::string>> cores; // (physical id, core id)
+	std::set<std::string> sockets;
+	std::string physicalId;
+	std::ifstream cpuinfo("/proc/cpuinfo");
+	for (std::string line; std::getline(cpuinfo, line);)
+	{
+		const size_t colon = line.find(':');
+		if (colon == std::string::npos)
+			continue;
+		std::string key = line.substr(0, colon);
+		key.erase(key.find_last_not_of(" \t") + 1);
+		const std::string value = colon + 2 <= line.size() ? line.substr(colon + 2) : "";
+
+		if (key == "model name")
+			topology.model = value;
+		else if (key == "physical id")
+		{
+			physicalId = value;
+			sockets.insert(value);
+		}
+		else if (key == "core id")
+			cores.emplace(physicalId, value);
+	}
+	topology.cores = static_cast<int>(cores.size());
+	topology.sockets = static_cast<int>(sockets.size());
+
+	const std::string smt = ReadFirstLine("/sys/devices/system/cpu/smt/active");
+	if (!smt.empty())
+		topology.smt = smt == "1" ? "on" : "off";
+	else if (topology.cores > 0)
+		topology.smt = static_cast<int>(std::thread::hardware_concurrency()) > topology.cores ? "on" : "off";
+
+	const std::string governor = ReadFirstLine("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+	if (!governor.empty())
+		topology.governor = governor;
+
+	// "always [madvise] never" -> "madvise"
+	const std::string thp = ReadFirstLine("/sys/kernel/mm/transparent_hugepage/enabled");
+	const size_t open = thp.find('['), close = thp.find(']');
+	if (open != std::string::npos && close != std::string::npos)
+		topology.transparentHugePages = thp.substr(open + 1, close - open - 1);
+	return topology;
+}
+
+#endif
+
+int PhysicalCoreCount()
+{
+	static const int cores = ReadCpuTopology().cores;
+	return cores;
+}
+
+Fingerprint CollectFingerprint(int workerLimit)
+{
+	const CpuTopology topology = ReadCpuTopology();
+	return {
+		{ "cpu_model", topology.model },
+		{ "logical_cpus", std::to_string(std::thread::hardware_concurrency()) },
+		{ "physical_cores", std::to_string(topology.cores) },
+		{ "sockets", std::to_string(topology.sockets) },
+		{ "smt", topology.smt },
+		{ "caches", CacheSizes() },
+		{ "frequency_governor", topology.governor },
+		{ "transparent_huge_pages", topology.transparentHugePages },
+		{ "compiler", CompilerName() },
+		{ "compiler_flags", CompilerFlags() },
+		{ "tbb_version", TbbVersion() },
+		{ "pstl_version", PstlVersion() },
+#if defined(__PSTL_USE_TBB)
+		{ "pstl_use_tbb", "yes" },
+#else
+		{ "pstl_use_tbb", "no" },
+#endif
+		{ "worker_limit", workerLimit > 0 ? std::to_string(workerLimit) : "unlimited" },
+	};
+}
+
+std::vector<std::string> FingerprintMismatches(const Fingerprint& a, const Fingerprint& b)
+{
+	const std::map<std::string, std::string> left(a.begin(), a.end()), right(b.begin(), b.end());
+	std::set<std::string> keys;
+	for (const auto& entry : a)
+		keys.insert(entry.first);
+	for (const auto& entry : b)
+		keys.insert(entry.first);
+
+	std::vector<std::string> mismatches;
+	for (const auto& key : keys)
+	{
+		const auto l = left.find(key), r = right.find(key);
+		const std::string lv = l == left.end() ? "<missing>" : l->second;
+		const std::string rv = r == right.end() ? "<missing>" : r->second;
+		if (lv != rv)
+			mismatches.push_back(key + ": " + lv + " != " + rv);
+	}
+	return mismatches;
+}
+
+bool FingerprintJSONReporter::ReportContext(const Context& context)
+{
+	std::ostream& out = GetOutputStream();
+	std::ostringstream buffer;
+	SetOutputStream(&buffer);
+	const bool ok = JSONReporter::ReportContext(context);
+	SetOutputStream(&out);
+
+	// the context object is the last one closed before "benchmarks"
+	std::string text = buffer.str();
+	const size_t benchmarks = text.rfind("\"benchmarks\"");
+	const size_t close = benchmarks == std::string::npos ? std::string::npos : text.rfind('}', benchmarks);
+	if (close != std::string::npos)
+	{
+		const size_t lastValue = text.find_last_not_of(" \t\r\n", close - 1) + 1;
+		std::ostringstream fields;
+		fields << ",\n    \"fingerprint\": {";
+		for (size_t i = 0; i < fingerprint_.size(); ++i)
+		{
+			fields << (i == 0 ? "\n" : ",\n") << "      \"" << JsonEscape(fingerprint_[i].first) << "\": \""
+				<< JsonEscape(fingerprint_[i].second) << "\"";
+		}
+		fields << "\n    }";
+		text.insert(lastValue, fields.str());
+	}
+	out << text;
+	return ok;
+}
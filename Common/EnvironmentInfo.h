@@ -0,0 +1,37 @@
+﻿#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+// Ordered description of the machine, OS tuning and build a run was made on. Results
+// are only comparable when the fingerprints match.
+using Fingerprint = std::vector<std::pair<std::string, std::string>>;
+
+// Collects CPU model, core / thread / socket counts, caches, SMT, frequency governor,
+// transparent huge pages, compiler and flags, TBB and pstl versions. workerLimit is
+// the tbb::global_control limit of the run (0 = unlimited).
+Fingerprint CollectFingerprint(int workerLimit);
+
+// Physical cores across all sockets (SMT siblings counted once), 0 if unknown. Read
+// once and cached.
+int PhysicalCoreCount();
+
+// Fields that differ between two fingerprints, as "key: a != b" lines.
+std::vector<std::string> FingerprintMismatches(const Fingerprint& a, const Fingerprint& b);
+
+// google-benchmark JSON output with a "fingerprint" object added to the "context".
+// The 1.4 reporter has no hook for custom context entries, so the base context is
+// rendered into a buffer and patched before it reaches the file.
+class FingerprintJSONReporter : public benchmark::JSONReporter
+{
+public:
+	explicit FingerprintJSONReporter(Fingerprint fingerprint) : fingerprint_(std::move(fingerprint)) {}
+
+	bool ReportContext(const Context& context) override;
+
+private:
+	Fingerprint fingerprint_;
+};
@@ -0,0 +1,51 @@
+﻿#include "ImplementationReport.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <string>
+
+void PrintImplementationReport(std::ostream& out, const std::vector<BenchmarkResult>& results)
+{
+	// kernel -> N -> policy -> best time
+	std::map<std::string, std::map<int64_t, std::map<std::string, double>>> timings;
+	std::map<std::string, std::set<std::string>> policies;
+	for (const auto& r : results)
+	{
+		auto& t = timings[r.kernel][r.size];
+		const auto it = t.find(r.policy);
+		t[r.policy] = it == t.end() ? r.realTimeNs : std::min(it->second, r.realTimeNs);
+		policies[r.kernel].insert(r.policy);
+	}
+
+	out << std::fixed << std::setprecision(1);
+	for (const auto& kernel : timings)
+	{
+		const auto& columns = policies[kernel.first];
+		const int width = static_cast<int>(std::max_element(columns.begin(), columns.end(),
+			[](const std::string& a, const std::string& b) { return a.size() < b.size(); })->size()) + 2;
+
+		out << "\n" << kernel.first << " (us)\n" << std::setw(10) << "N";
+		for (const auto& policy : columns)
+			out << std::setw(std::max(width, 12)) << policy;
+		out << "  best\n";
+
+		for (const auto& row : kernel.second)
+		{
+			out << std::setw(10) << row.first;
+			for (const auto& policy : columns)
+			{
+				const auto it = row.second.find(policy);
+				if (it == row.second.end())
+					out << std::setw(std::max(width, 12)) << "-";
+				else
+					out << std::setw(std::max(width, 12)) << it->second / 1000.0;
+			}
+			const auto best = std::min_element(row.second.begin(), row.second.end(),
+				[](const auto& a, const auto& b) { return a.second < b.second; });
+			out << "  " << best->first << '\n';
+		}
+	}
+	out.unsetf(std::ios::floatfield);
+}
@@ -0,0 +1,11 @@
+﻿#pragma once
+
+#include <ostream>
+#include <vector>
+
+#include "BenchmarkResults.h"
+
+// One table per kernel: rows are N, columns are the "<implementation>_<policy>"
+// registrations (std_par, pstl_par, threads_par, ...), cells are the real time in
+// microseconds, and the last column names the fastest one.
+void PrintImplementationReport(std::ostream& out, const std::vector<BenchmarkResult>& results);
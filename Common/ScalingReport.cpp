@@ -0,0 +1,108 @@
+﻿#include "ScalingReport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <set>
+#include <tuple>
+
+AmdahlFit FitAmdahl(const std::vector<int>& threads, const std::vector<double>& speedups, double minEfficiency)
+{
+	// 1/S - 1/p = f * (1 - 1/p), so f is a least squares fit through the origin
+	double sxy = 0.0, sxx = 0.0;
+	for (size_t i = 0; i < threads.size(); ++i)
+	{
+		if (threads[i] <= 1 || speedups[i] <= 0.0)
+			continue;
+		const double p = threads[i];
+		const double x = 1.0 - 1.0 / p;
+		const double y = 1.0 / speedups[i] - 1.0 / p;
+		sxy += x * y;
+		sxx += x * x;
+	}
+
+	AmdahlFit fit;
+	if (sxx == 0.0)
+		return fit;
+
+	fit.serialFraction = std::clamp(sxy / sxx, 0.0, 1.0);
+	// efficiency(p) = 1 / (p * f + 1 - f) >= E  <=>  p <= 1 + (1/E - 1) / f
+	fit.maxUsefulThreads = fit.serialFraction > 0.0
+		? 1.0 + (1.0 / minEfficiency - 1.0) / fit.serialFraction
+		: std::numeric_limits<double>::infinity();
+	return fit;
+}
+
+double GustafsonSpeedup(double serialFraction, int threads)
+{
+	return threads - serialFraction * (threads - 1);
+}
+
+void PrintScalingReport(std::ostream& out, const std::vector<BenchmarkResult>& results, double minEfficiency)
+{
+	using Key = std::tuple<std::string, std::string, int64_t>;
+	std::map<Key, std::map<int, double>> timings; // best time per thread count
+	std::set<int> threadCounts;
+	for (const auto& r : results)
+	{
+		auto& t = timings[Key(r.kernel, r.policy, r.size)];
+		const auto it = t.find(r.threads);
+		t[r.threads] = it == t.end() ? r.realTimeNs : std::min(it->second, r.realTimeNs);
+		threadCounts.insert(r.threads);
+	}
+	if (threadCounts.size() < 2 || threadCounts.count(1) == 0)
+	{
+		out << "scaling report needs runs at 1 thread and at least one other thread count\n";
+		return;
+	}
+	const int maxThreads = *threadCounts.rbegin();
+
+	out << "\nScaling report (speedup vs 1 thread, efficiency = speedup / threads, min efficiency "
+		<< minEfficiency << ")\n";
+	out << std::left << std::setw(22) << "kernel" << std::setw(16) << "policy" << std::right << std::setw(10) << "N";
+	for (int p : threadCounts)
+		out << std::setw(9) << ("S@" + std::to_string(p));
+	out << std::setw(9) << ("E@" + std::to_string(maxThreads)) << std::setw(9) << "serial"
+		<< std::setw(11) << "gustafson" << std::setw(12) << "max_useful" << '\n';
+
+	out << std::fixed << std::setprecision(2);
+	for (const auto& entry : timings)
+	{
+		const auto& t = entry.second;
+		const auto base = t.find(1);
+		if (base == t.end())
+			continue;
+
+		std::vector<int> ps;
+		std::vector<double> speedups;
+		out << std::left << std::setw(22) << std::get<0>(entry.first) << std::setw(16) << std::get<1>(entry.first)
+			<< std::right << std::setw(10) << std::get<2>(entry.first);
+		for (int p : threadCounts)
+		{
+			const auto it = t.find(p);
+			if (it == t.end())
+			{
+				out << std::setw(9) << "-";
+				continue;
+			}
+			const double speedup = base->second / it->second;
+			ps.push_back(p);
+			speedups.push_back(speedup);
+			out << std::setw(9) << speedup;
+		}
+
+		const auto top = t.find(maxThreads);
+		const double efficiency = top != t.end() ? base->second / top->second / maxThreads : 0.0;
+		const AmdahlFit fit = FitAmdahl(ps, speedups, minEfficiency);
+		out << std::setw(9) << efficiency << std::setw(9) << fit.serialFraction
+			<< std::setw(11) << GustafsonSpeedup(fit.serialFraction, maxThreads);
+		if (std::isinf(fit.maxUsefulThreads))
+			out << std::setw(12) << "inf";
+		else
+			out << std::setw(12) << static_cast<int>(fit.maxUsefulThreads);
+		out << '\n';
+	}
+	out.unsetf(std::ios::floatfield);
+}
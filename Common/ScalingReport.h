@@ -0,0 +1,23 @@
+﻿#pragma once
+
+#include <ostream>
+#include <vector>
+
+#include "BenchmarkResults.h"
+
+// Amdahl's law fit of speedup(p) = 1 / (f + (1 - f) / p) over measured (threads, speedup) pairs.
+struct AmdahlFit
+{
+	double serialFraction = 1.0;
+	double maxUsefulThreads = 1.0; // thread count where projected efficiency drops to the threshold
+};
+
+AmdahlFit FitAmdahl(const std::vector<int>& threads, const std::vector<double>& speedups, double minEfficiency);
+
+// Gustafson's scaled speedup for p threads with serial fraction f: p - f * (p - 1).
+double GustafsonSpeedup(double serialFraction, int threads);
+
+// Groups results by (kernel, policy, N), takes the single-thread run as the baseline
+// and prints speedup, efficiency, fitted serial fraction and the projected maximum
+// useful thread count. Results must come from runs with different thread limits.
+void PrintScalingReport(std::ostream& out, const std::vector<BenchmarkResult>& results, double minEfficiency);
@@ -0,0 +1,56 @@
+﻿#include "SimdReport.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <string>
+#include <utility>
+
+void PrintSimdReport(std::ostream& out, const std::vector<BenchmarkResult>& results)
+{
+	// best time per (kernel, N) and policy, over all thread limits
+	std::map<std::pair<std::string, int64_t>, std::map<std::string, double>> timings;
+	for (const auto& r : results)
+	{
+		auto& t = timings[std::make_pair(r.kernel, r.size)];
+		const auto it = t.find(r.policy);
+		t[r.policy] = it == t.end() ? r.realTimeNs : std::min(it->second, r.realTimeNs);
+	}
+
+	out << "\nSIMD / threads attribution (factors relative to novec_seq)\n";
+	out << std::left << std::setw(22) << "kernel" << std::right << std::setw(10) << "N"
+		<< std::setw(10) << "autovec" << std::setw(10) << "simd" << std::setw(10) << "threads"
+		<< std::setw(10) << "total" << std::setw(10) << "overlap" << '\n';
+	out << std::fixed << std::setprecision(2);
+
+	for (const auto& entry : timings)
+	{
+		const auto& t = entry.second;
+		const auto base = t.find("novec_seq");
+		if (base == t.end())
+			continue;
+
+		auto factor = [&](const char* policy) {
+			const auto it = t.find(policy);
+			return it == t.end() ? 0.0 : base->second / it->second;
+		};
+		auto print = [&](double value) {
+			if (value > 0.0)
+				out << std::setw(10) << value;
+			else
+				out << std::setw(10) << "-";
+		};
+
+		const double simd = factor("pstl_unseq");
+		const double threads = factor("novec_par");
+		const double total = factor("pstl_par_unseq");
+		out << std::left << std::setw(22) << entry.first.first << std::right << std::setw(10) << entry.first.second;
+		print(factor("pstl_seq"));
+		print(simd);
+		print(threads);
+		print(total);
+		print(simd > 0.0 && threads > 0.0 && total > 0.0 ? total / (simd * threads) : 0.0);
+		out << '\n';
+	}
+	out.unsetf(std::ios::floatfield);
+}
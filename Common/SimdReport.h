@@ -0,0 +1,17 @@
+﻿#pragma once
+
+#include <ostream>
+#include <vector>
+
+#include "BenchmarkResults.h"
+
+// Splits the speedup of every kernel into a SIMD and a threads factor. Needs the
+// "novec_*" registrations of a build with vectorization disabled next to the regular
+// "pstl_*" ones; all factors are relative to novec_seq (scalar, single thread):
+//	autovec  novec_seq / pstl_seq         what the compiler got out of plain seq
+//	simd     novec_seq / pstl_unseq       explicit vectorization
+//	threads  novec_seq / novec_par        threading without SIMD
+//	total    novec_seq / pstl_par_unseq   both levers
+// and "overlap" = total / (simd * threads), below 1 when the two compete for the same
+// bottleneck (usually memory bandwidth).
+void PrintSimdReport(std::ostream& out, const std::vector<BenchmarkResult>& results);
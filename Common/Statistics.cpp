@@ -0,0 +1,68 @@
+﻿#include "Statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <numeric>
+
+double Median(std::vector<double> values)
+{
+	if (values.empty())
+		return 0.0;
+	const size_t mid = values.size() / 2;
+	std::nth_element(values.begin(), values.begin() + mid, values.end());
+	const double upper = values[mid];
+	if (values.size() % 2 != 0)
+		return upper;
+	const double lower = *std::max_element(values.begin(), values.begin() + mid);
+	return 0.5 * (lower + upper);
+}
+
+double ScaledMAD(const std::vector<double>& values)
+{
+	const double med = Median(values);
+	std::vector<double> deviations(values.size());
+	std::transform(values.begin(), values.end(), deviations.begin(), [med](double v) { return std::abs(v - med); });
+	return 1.4826 * Median(std::move(deviations));
+}
+
+std::vector<double> RejectOutliers(const std::vector<double>& values, double threshold)
+{
+	const double med = Median(values);
+	const double mad = ScaledMAD(values);
+	if (mad == 0.0)
+		return values;
+
+	std::vector<double> kept;
+	std::copy_if(values.begin(), values.end(), std::back_inserter(kept),
+		[=](double v) { return std::abs(v - med) <= threshold * mad; });
+	return kept;
+}
+
+SampleSummary Summarize(const std::vector<double>& samples, double outlierThreshold)
+{
+	SampleSummary summary;
+	std::vector<double> kept = RejectOutliers(samples, outlierThreshold);
+	summary.count = kept.size();
+	summary.outliers = samples.size() - kept.size();
+	if (kept.empty())
+		return summary;
+
+	std::sort(kept.begin(), kept.end());
+	const double n = static_cast<double>(kept.size());
+	summary.median = Median(kept);
+	summary.mean = std::accumulate(kept.begin(), kept.end(), 0.0) / n;
+	const double sq = std::accumulate(kept.begin(), kept.end(), 0.0,
+		[m = summary.mean](double acc, double v) { return acc + (v - m) * (v - m); });
+	summary.stddev = kept.size() > 1 ? std::sqrt(sq / (n - 1.0)) : 0.0;
+	summary.cv = summary.mean > 0.0 ? summary.stddev / summary.mean : 0.0;
+
+	// ranks of the binomial(n, 0.5) based interval, normal approximation; the upper
+	// bound is a 1-based rank, hence the - 1 (n = 20 gives indices 5..14)
+	const double spread = 1.96 * std::sqrt(n) / 2.0;
+	const auto lo = static_cast<long>(std::floor(n / 2.0 - spread));
+	const auto hi = static_cast<long>(std::ceil(n / 2.0 + spread)) - 1;
+	summary.ciLow = kept[static_cast<size_t>(std::clamp(lo, 0L, static_cast<long>(n) - 1))];
+	summary.ciHigh = kept[static_cast<size_t>(std::clamp(hi, 0L, static_cast<long>(n) - 1))];
+	return summary;
+}
@@ -0,0 +1,37 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Robust summary of repeated timings of one benchmark.
+struct SampleSummary
+{
+	size_t count = 0;    // samples kept after outlier rejection
+	size_t outliers = 0; // samples discarded
+	double median = 0.0;
+	double ciLow = 0.0;  // 95% confidence interval of the median
+	double ciHigh = 0.0;
+	double mean = 0.0;
+	double stddev = 0.0;
+	double cv = 0.0;     // coefficient of variation, stddev / mean
+
+	// half of the CI width relative to the median, e.g. 0.02 for +-2%
+	double RelativeHalfWidth() const { return median > 0.0 ? 0.5 * (ciHigh - ciLow) / median : 0.0; }
+
+	// below 6 samples the order statistics cannot bound the median at 95%
+	bool Converged(double target) const { return count >= 6 && RelativeHalfWidth() <= target; }
+};
+
+double Median(std::vector<double> values);
+
+// Median absolute deviation, scaled by 1.4826 so it estimates the standard deviation
+// of normally distributed data.
+double ScaledMAD(const std::vector<double>& values);
+
+// Keeps the values within threshold * ScaledMAD of the median.
+std::vector<double> RejectOutliers(const std::vector<double>& values, double threshold);
+
+// Rejects outliers and computes the distribution free (order statistics based) 95%
+// confidence interval of the median. With fewer than ~6 samples the interval is the
+// full range of the data.
+SampleSummary Summarize(const std::vector<double>& samples, double outlierThreshold);
@@ -0,0 +1,122 @@
+﻿#pragma once
+
+// Kernels shared by the vectorized (IntelCompilerTests.cpp) and the scalar
+// (IntelCompilerTestsScalar.cpp) builds. Everything here must stay static or depend on
+// lambda types, otherwise the linker may fold both builds into one copy.
+
+#include <algorithm>
+#include <chrono>
+#include <execution>
+#include <iostream>
+#include <vector>
+#include <random>
+
+#include <pstl/algorithm>
+#include <pstl/numeric>
+#include <pstl/execution>
+#include <pstl/memory>
+#include <pstl/iterators.h>
+
+#include "glm/vec4.hpp" // glm::vec4
+#include "glm/geometric.hpp"
+#include "glm/gtc/constants.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+inline float GenRandomFloat(float lower, float upper)
+{
+	// usage of thread local random engines allows running the generator in concurrent mode
+	thread_local static std::default_random_engine rd;
+	std::uniform_real_distribution<float> dist(lower, upper);
+	return dist(rd);
+}
+
+inline int GenRandomInt(int lower, int upper)
+{
+	// usage of thread local random engines allows running the generator in concurrent mode
+	thread_local static std::default_random_engine rd;
+	std::uniform_int_distribution<int> dist(lower, upper);
+	return dist(rd);
+}
+
+template <typename Policy>
+static void BM_Trigonometry(benchmark::State& state, Policy execution_policy)
+{
+	std::vector<double> vec(state.range(0), 0.5);
+	std::generate(vec.begin(), vec.end(), []() { return GenRandomFloat(0.0f, 0.5f*glm::pi<float>()); });
+	std::vector<double> out(vec);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::transform(execution_policy, vec.begin(), vec.end(), out.begin(),
+			[](double v) {
+			return std::sqrt(std::sin(v)*std::cos(v));
+		}
+		);
+	}
+}
+
+template <typename Policy>
+static void BM_SortPoints(benchmark::State& state, Policy execution_policy)
+{
+	std::vector<glm::vec4> points(state.range(0), { 0.0f, 1.0f, 0.0f, 1.0f });
+	std::generate(points.begin(), points.end(), []() {
+		return glm::vec4(GenRandomFloat(-1.0f, 1.0f), GenRandomFloat(-1.0f, 1.0f), GenRandomFloat(-1.0f, 1.0f), 1.0f);
+	});
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::sort(execution_policy, points.begin(), points.end(),
+			[](const glm::vec4& a, const glm::vec4& b) { return a.x < b.x; }
+		);
+	}
+}
+
+template <typename Policy>
+static void BM_DotProduct(benchmark::State& state, Policy execution_policy)
+{
+	std::vector<double> firstVec(state.range(0)), secondVec(state.range(0));
+
+	std::generate(pstl::execution::par, firstVec.begin(), firstVec.end(), []() { return GenRandomFloat(-1.0f, 1.0f); });
+	std::generate(pstl::execution::par, secondVec.begin(), secondVec.end(), []() { return GenRandomFloat(-1.0f, 1.0f); });
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		// lambdas instead of std::plus/std::multiplies keep the pstl instantiations local to
+		// each translation unit, so the scalar build cannot share code with the vectorized one
+		double res = std::transform_reduce(execution_policy, firstVec.cbegin(), firstVec.cend(), secondVec.cbegin(), 0.0,
+			[](double a, double b) { return a + b; }, [](double a, double b) { return a * b; });
+		benchmark::DoNotOptimize(res);
+	}
+}
+
+template <typename Policy>
+static void BM_CountingIter(benchmark::State& state, Policy execution_policy)
+{
+	const auto VecSize = state.range(0);
+	std::vector<double> prices(VecSize);
+	std::vector<unsigned int> quantities(VecSize);
+	std::vector<double> discounts(VecSize);
+	std::vector<double> profit(VecSize);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::for_each(execution_policy, pstl::counting_iterator<int64_t>(0), pstl::counting_iterator<int64_t>(VecSize),
+			[&prices, &quantities, &discounts](int64_t i) {
+			prices[i] = GenRandomFloat(0.5f, 100.0f);
+			quantities[i] = GenRandomInt(1, 100);
+			discounts[i] = GenRandomFloat(0.0f, 0.5f); // max 50%
+		});
+
+		std::transform(execution_policy, pstl::counting_iterator<int64_t>(0), pstl::counting_iterator<int64_t>(VecSize), profit.begin(),
+			[&prices, &quantities, &discounts](int i) {
+			return (prices[i] * (1.0f - discounts[i]))*quantities[i];
+		});
+	}
+}
@@ -0,0 +1,27 @@
+﻿// Same kernels as IntelCompilerTests.cpp, but this file is compiled with the
+// auto-vectorizer and OpenMP SIMD switched off (/Qvec- /Qopenmp-simd- in the project
+// file), so unseq degrades to plain scalar loops. Together with the vectorized build the
+// driver's --simd_report splits every speedup into a SIMD and a threads factor.
+#if defined(__GNUC__) && !defined(__INTEL_COMPILER) && !defined(__clang__)
+#pragma GCC optimize("no-tree-vectorize")
+#endif
+
+#include "CompilerTestKernels.h"
+
+BENCHMARK_CAPTURE(BM_Trigonometry, novec_seq, pstl::execution::seq)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Trigonometry, novec_unseq, pstl::execution::unseq)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Trigonometry, novec_par, pstl::execution::par)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_Trigonometry, novec_par_unseq, pstl::execution::par_unseq)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_SortPoints, novec_seq, pstl::execution::seq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SortPoints, novec_par, pstl::execution::par)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_DotProduct, novec_seq, pstl::execution::seq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DotProduct, novec_unseq, pstl::execution::unseq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DotProduct, novec_par, pstl::execution::par)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DotProduct, novec_par_unseq, pstl::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_CountingIter, novec_seq, pstl::execution::seq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_CountingIter, novec_unseq, pstl::execution::unseq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_CountingIter, novec_par, pstl::execution::par)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_CountingIter, novec_par_unseq, pstl::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,99 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <execution>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+#include <pstl/execution>
+
+#include "ThreadedAlgorithms.h"
+
+// Lets one kernel template run against every implementation: standard and pstl
+// policies go to the std:: overloads, threaded::execution::par goes to the
+// hand-rolled std::thread versions.
+namespace algo
+{
+	template <typename Policy>
+	constexpr bool IsThreaded = threaded::is_execution_policy_v<std::decay_t<Policy>>;
+
+	// seq / unseq policies, which run on the calling thread only
+	template <typename Policy>
+	constexpr bool IsSequential =
+		std::is_same_v<std::decay_t<Policy>, std::execution::sequenced_policy>
+		|| std::is_same_v<std::decay_t<Policy>, pstl::execution::sequenced_policy>
+		|| std::is_same_v<std::decay_t<Policy>, pstl::execution::unsequenced_policy>;
+
+	template <typename Policy, typename... Args>
+	decltype(auto) for_each(Policy&& policy, Args&&... args)
+	{
+		if constexpr (IsThreaded<Policy>)
+			return threaded::for_each(std::forward<Args>(args)...);
+		else
+			return std::for_each(std::forward<Policy>(policy), std::forward<Args>(args)...);
+	}
+
+	template <typename Policy, typename... Args>
+	decltype(auto) transform(Policy&& policy, Args&&... args)
+	{
+		if constexpr (IsThreaded<Policy>)
+			return threaded::transform(std::forward<Args>(args)...);
+		else
+			return std::transform(std::forward<Policy>(policy), std::forward<Args>(args)...);
+	}
+
+	template <typename Policy, typename... Args>
+	decltype(auto) transform_reduce(Policy&& policy, Args&&... args)
+	{
+		if constexpr (IsThreaded<Policy>)
+			return threaded::transform_reduce(std::forward<Args>(args)...);
+		else
+			return std::transform_reduce(std::forward<Policy>(policy), std::forward<Args>(args)...);
+	}
+
+	template <typename Policy, typename... Args>
+	decltype(auto) transform_inclusive_scan(Policy&& policy, Args&&... args)
+	{
+		if constexpr (IsThreaded<Policy>)
+			return threaded::transform_inclusive_scan(std::forward<Args>(args)...);
+		else
+			return std::transform_inclusive_scan(std::forward<Policy>(policy), std::forward<Args>(args)...);
+	}
+
+	template <typename Policy, typename... Args>
+	decltype(auto) copy_if(Policy&& policy, Args&&... args)
+	{
+		if constexpr (IsThreaded<Policy>)
+			return threaded::copy_if(std::forward<Args>(args)...);
+		else
+			return std::copy_if(std::forward<Policy>(policy), std::forward<Args>(args)...);
+	}
+
+	template <typename Policy, typename... Args>
+	decltype(auto) unique(Policy&& policy, Args&&... args)
+	{
+		if constexpr (IsThreaded<Policy>)
+			return threaded::unique(std::forward<Args>(args)...);
+		else
+			return std::unique(std::forward<Policy>(policy), std::forward<Args>(args)...);
+	}
+
+	template <typename Policy, typename... Args>
+	decltype(auto) sort(Policy&& policy, Args&&... args)
+	{
+		if constexpr (IsThreaded<Policy>)
+			return threaded::sort(std::forward<Args>(args)...);
+		else
+			return std::sort(std::forward<Policy>(policy), std::forward<Args>(args)...);
+	}
+
+	template <typename Policy, typename... Args>
+	decltype(auto) stable_sort(Policy&& policy, Args&&... args)
+	{
+		if constexpr (IsThreaded<Policy>)
+			return threaded::stable_sort(std::forward<Args>(args)...);
+		else
+			return std::stable_sort(std::forward<Policy>(policy), std::forward<Args>(args)...);
+	}
+}
@@ -0,0 +1,131 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "AlgorithmDispatch.h"
+
+// Stable out-of-place partition into B buckets, the building block of radix sort,
+// hash partitioned joins and grid builds (pstl has nothing like it):
+//	1. every chunk counts its elements per bucket
+//	2. exclusive scan over the counts, bucket-major and chunk-minor
+//	3. every chunk scatters its elements to its own slots of each bucket
+// Chunks follow the policy: one per worker for parallel policies (run through the
+// policy's scheduler, or plain threads for threaded::execution::par), a single chunk
+// for seq / unseq. Within a bucket, elements keep their input order.
+namespace bucket
+{
+	template <typename Policy, typename Body>
+	void ForEachChunk(Policy&& policy, std::ptrdiff_t chunks, Body body)
+	{
+		if constexpr (algo::IsThreaded<Policy>)
+		{
+			threaded::ParallelChunks(chunks, chunks, [&body](std::ptrdiff_t c, std::ptrdiff_t, std::ptrdiff_t) { body(c); });
+		}
+		else
+		{
+			std::vector<std::ptrdiff_t> ids(chunks);
+			std::iota(ids.begin(), ids.end(), 0);
+			std::for_each(std::forward<Policy>(policy), ids.begin(), ids.end(), body);
+		}
+	}
+
+	// Per chunk bucket counts of [first, first + size), turned into scatter offsets by
+	// ComputeOffsets. Every chunk's row starts on its own cache line and is padded to
+	// whole lines, so the counter increments of neighbouring chunks don't false-share
+	// (a row of 2 or 16 buckets is a fraction of a line).
+	class ChunkCounts
+	{
+	public:
+		static constexpr std::size_t LineBytes = 64;
+		static constexpr std::size_t LineWords = LineBytes / sizeof(std::size_t);
+
+		template <typename Policy>
+		ChunkCounts(Policy&&, std::ptrdiff_t size, std::size_t buckets)
+			: size_(size), buckets_(buckets), chunks_(algo::IsSequential<Policy> ? 1 : threaded::ChunkCount(size)),
+			stride_((buckets + LineWords - 1) / LineWords * LineWords), storage_(chunks_ * stride_ + LineWords - 1)
+		{
+			// skip to the first line boundary of the storage
+			const auto address = reinterpret_cast<std::uintptr_t>(storage_.data());
+			first_ = (LineBytes - address % LineBytes) % LineBytes / sizeof(std::size_t);
+		}
+
+		std::ptrdiff_t Chunks() const { return chunks_; }
+		std::size_t Buckets() const { return buckets_; }
+		std::ptrdiff_t ChunkBegin(std::ptrdiff_t c) const { return size_ * c / chunks_; }
+		std::size_t* Chunk(std::ptrdiff_t c) { return storage_.data() + first_ + c * stride_; }
+
+		std::size_t BucketTotal(std::size_t b) const
+		{
+			std::size_t total = 0;
+			for (std::ptrdiff_t c = 0; c < chunks_; ++c)
+				total += Row(c)[b];
+			return total;
+		}
+
+		// Replaces the counts with each chunk's first slot per bucket; returns the
+		// bucket begin offsets (buckets + 1 entries).
+		std::vector<std::size_t> ComputeOffsets()
+		{
+			std::vector<std::size_t> bucketBegin(buckets_ + 1, 0);
+			std::size_t running = 0;
+			for (std::size_t b = 0; b < buckets_; ++b)
+			{
+				bucketBegin[b] = running;
+				for (std::ptrdiff_t c = 0; c < chunks_; ++c)
+					running += std::exchange(Chunk(c)[b], running);
+			}
+			bucketBegin[buckets_] = running;
+			return bucketBegin;
+		}
+
+	private:
+		const std::size_t* Row(std::ptrdiff_t c) const { return storage_.data() + first_ + c * stride_; }
+
+		std::ptrdiff_t size_;
+		std::size_t buckets_;
+		std::ptrdiff_t chunks_;
+		std::size_t stride_; // buckets rounded up to whole cache lines
+		std::vector<std::size_t> storage_;
+		std::size_t first_ = 0;
+	};
+
+	template <typename Policy, typename RandomIt, typename BucketOf>
+	void Count(Policy&& policy, RandomIt first, ChunkCounts& counts, BucketOf bucketOf)
+	{
+		ForEachChunk(policy, counts.Chunks(), [first, &counts, &bucketOf](std::ptrdiff_t c) {
+			std::size_t* count = counts.Chunk(c);
+			std::fill(count, count + counts.Buckets(), std::size_t(0));
+			for (std::ptrdiff_t i = counts.ChunkBegin(c); i < counts.ChunkBegin(c + 1); ++i)
+				++count[bucketOf(first[i])];
+		});
+	}
+
+	// counts must hold offsets (ComputeOffsets) and is consumed
+	template <typename Policy, typename RandomIt, typename OutputIt, typename BucketOf>
+	void Scatter(Policy&& policy, RandomIt first, OutputIt out, ChunkCounts& counts, BucketOf bucketOf)
+	{
+		ForEachChunk(policy, counts.Chunks(), [first, out, &counts, &bucketOf](std::ptrdiff_t c) {
+			std::size_t* offset = counts.Chunk(c);
+			for (std::ptrdiff_t i = counts.ChunkBegin(c); i < counts.ChunkBegin(c + 1); ++i)
+				out[offset[bucketOf(first[i])]++] = first[i];
+		});
+	}
+
+	// Writes [first, last) to out grouped by bucketOf(element) in [0, buckets) and
+	// returns the bucket begin offsets in out (buckets + 1 entries).
+	template <typename Policy, typename RandomIt, typename OutputIt, typename BucketOf>
+	std::vector<std::size_t> Partition(Policy&& policy, RandomIt first, RandomIt last, OutputIt out, std::size_t buckets, BucketOf bucketOf)
+	{
+		ChunkCounts counts(policy, std::distance(first, last), buckets);
+		Count(policy, first, counts, bucketOf);
+		auto bucketBegin = counts.ComputeOffsets();
+		Scatter(policy, first, out, counts, bucketOf);
+		return bucketBegin;
+	}
+}
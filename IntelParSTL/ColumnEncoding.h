@@ -0,0 +1,89 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Narrow encodings for columns whose value range is known, trading a little decode
+// arithmetic for memory bandwidth. Decoding is branch free so it can sit inside a
+// vectorised kernel.
+
+// Values in [0, max] stored as one byte codes, step max / 255.
+struct FixedPoint8
+{
+	float step;
+
+	explicit FixedPoint8(float max) : step(max / 255.0f) {}
+
+	std::uint8_t Encode(double value) const
+	{
+		return static_cast<std::uint8_t>(std::clamp(std::lround(value / step), 0l, 255l));
+	}
+
+	float Decode(std::uint8_t code) const { return code * step; }
+};
+
+// Frame of reference plus bit packing: value - reference stored in the minimum number
+// of bits, back to back. Get(i) does one unaligned 8-byte load, a shift and a mask;
+// the buffer is padded so the load never runs past the end. A value at an arbitrary bit
+// offset only fits one 8-byte load if it has at most MaxPackedBits bits; wider spans
+// fall back to plain 64-bit values, which sit at byte offsets and need no shift.
+class BitPackedColumn
+{
+public:
+	static constexpr unsigned MaxPackedBits = 57;
+
+	BitPackedColumn() = default;
+
+	template <typename InputIt>
+	BitPackedColumn(InputIt first, InputIt last)
+	{
+		size_ = static_cast<std::size_t>(std::distance(first, last));
+		if (size_ == 0)
+			return;
+
+		const auto range = std::minmax_element(first, last);
+		reference_ = static_cast<std::int64_t>(*range.first);
+		const std::uint64_t span = static_cast<std::uint64_t>(static_cast<std::int64_t>(*range.second)) - static_cast<std::uint64_t>(reference_);
+		bits_ = 1;
+		while (bits_ < 64 && (span >> bits_) != 0)
+			++bits_;
+		if (bits_ > MaxPackedBits)
+			bits_ = 64;
+		mask_ = bits_ == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bits_) - 1;
+
+		bytes_.assign((size_ * bits_ + 7) / 8 + sizeof(std::uint64_t), 0);
+		std::size_t i = 0;
+		for (auto it = first; it != last; ++it, ++i)
+		{
+			const std::uint64_t delta = static_cast<std::uint64_t>(static_cast<std::int64_t>(*it)) - static_cast<std::uint64_t>(reference_);
+			const std::size_t bit = i * bits_;
+			std::uint64_t word;
+			std::memcpy(&word, &bytes_[bit / 8], sizeof(word));
+			word |= delta << (bit % 8);
+			std::memcpy(&bytes_[bit / 8], &word, sizeof(word));
+		}
+	}
+
+	std::size_t Size() const { return size_; }
+	unsigned Bits() const { return bits_; }
+	std::size_t Bytes() const { return bytes_.size(); }
+
+	std::int64_t Get(std::size_t i) const
+	{
+		const std::size_t bit = i * bits_;
+		std::uint64_t word;
+		std::memcpy(&word, &bytes_[bit / 8], sizeof(word));
+		return static_cast<std::int64_t>(static_cast<std::uint64_t>(reference_) + ((word >> (bit % 8)) & mask_));
+	}
+
+private:
+	std::vector<std::uint8_t> bytes_;
+	std::size_t size_ = 0;
+	std::int64_t reference_ = 0;
+	unsigned bits_ = 0;
+	std::uint64_t mask_ = 0;
+};
@@ -0,0 +1,248 @@
+﻿#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <pstl/iterators.h>
+
+#include "AlgorithmDispatch.h"
+
+// Typed column store: a table is a list of column tags, every column is a 64-byte
+// aligned vector of the tag's value type, and all columns share one row count.
+//
+//	struct Price : columnar::ColumnTag<double> { static constexpr const char* Name = "price"; };
+//	struct Quantity : columnar::ColumnTag<unsigned int> { static constexpr const char* Name = "quantity"; };
+//	columnar::ColumnTable<Price, Quantity, Revenue> table(rows);
+//
+//	table.Compute<Revenue>(policy, columnar::Col<Price>() * columnar::Col<Quantity>());
+//	double total = table.Reduce<Revenue>(policy, 0.0, std::plus<>());
+//	table.Select<Price, Quantity>().ForEachRow(policy, [](double price, unsigned int quantity) { ... });
+//
+// Everything runs through the algo:: wrappers over row indices, and expressions are
+// templates that inline down to the same loop as hand written code on raw vectors.
+namespace columnar
+{
+	template <typename T, std::size_t Alignment = 64>
+	struct AlignedAllocator
+	{
+		using value_type = T;
+
+		template <typename U>
+		struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+		AlignedAllocator() = default;
+		template <typename U>
+		AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+		T* allocate(std::size_t n)
+		{
+			return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+		}
+
+		void deallocate(T* p, std::size_t)
+		{
+			::operator delete(p, std::align_val_t(Alignment));
+		}
+
+		template <typename U>
+		bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+		template <typename U>
+		bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+	};
+
+	template <typename T>
+	using Column = std::vector<T, AlignedAllocator<T>>;
+
+	template <typename T>
+	struct ColumnTag
+	{
+		using ValueType = T;
+	};
+
+	template <typename Field, typename... Fields>
+	struct IndexOf;
+
+	template <typename Field, typename... Rest>
+	struct IndexOf<Field, Field, Rest...> : std::integral_constant<std::size_t, 0> {};
+
+	template <typename Field, typename First, typename... Rest>
+	struct IndexOf<Field, First, Rest...> : std::integral_constant<std::size_t, 1 + IndexOf<Field, Rest...>::value> {};
+
+	// Read-only projection: pointers to some columns of a table, in the listed order.
+	template <typename... Fields>
+	class ColumnView
+	{
+	public:
+		ColumnView(std::size_t rows, const typename Fields::ValueType*... data) : rows_(rows), data_(data...) {}
+
+		std::size_t Rows() const { return rows_; }
+
+		template <typename Field>
+		const typename Field::ValueType* Data() const
+		{
+			return std::get<IndexOf<Field, Fields...>::value>(data_);
+		}
+
+		// f(value of every selected column) for every row
+		template <typename Policy, typename Function>
+		void ForEachRow(Policy&& policy, Function f) const
+		{
+			const auto data = data_;
+			algo::for_each(std::forward<Policy>(policy), pstl::counting_iterator<std::ptrdiff_t>(0), pstl::counting_iterator<std::ptrdiff_t>(rows_),
+				[data, f](std::ptrdiff_t i) { std::apply([&](const auto*... column) { f(column[i]...); }, data); });
+		}
+
+		// reduce(transform(value of every selected column)) over all rows
+		template <typename Policy, typename T, typename Reduce, typename Transform>
+		T TransformReduce(Policy&& policy, T init, Reduce reduce, Transform transform) const
+		{
+			const auto data = data_;
+			return algo::transform_reduce(std::forward<Policy>(policy), pstl::counting_iterator<std::ptrdiff_t>(0), pstl::counting_iterator<std::ptrdiff_t>(rows_),
+				init, reduce, [data, transform](std::ptrdiff_t i) { return std::apply([&](const auto*... column) { return transform(column[i]...); }, data); });
+		}
+
+	private:
+		std::size_t rows_;
+		std::tuple<const typename Fields::ValueType*...> data_;
+	};
+
+	template <typename... Fields>
+	class ColumnTable
+	{
+	public:
+		explicit ColumnTable(std::size_t rows = 0) { Resize(rows); }
+
+		std::size_t Rows() const { return rows_; }
+
+		static constexpr std::array<const char*, sizeof...(Fields)> ColumnNames() { return { Fields::Name... }; }
+
+		void Resize(std::size_t rows)
+		{
+			rows_ = rows;
+			std::apply([rows](auto&... column) { (column.resize(rows), ...); }, columns_);
+		}
+
+		template <typename Field>
+		Column<typename Field::ValueType>& Get() { return std::get<IndexOf<Field, Fields...>::value>(columns_); }
+
+		template <typename Field>
+		const Column<typename Field::ValueType>& Get() const { return std::get<IndexOf<Field, Fields...>::value>(columns_); }
+
+		template <typename... Selected>
+		ColumnView<Selected...> Select() const
+		{
+			return ColumnView<Selected...>(rows_, Get<Selected>().data()...);
+		}
+
+		// Target = expression, evaluated row by row
+		template <typename Target, typename Policy, typename Expression>
+		void Compute(Policy&& policy, const Expression& expression)
+		{
+			const auto evaluate = expression.Bind(*this);
+			algo::transform(std::forward<Policy>(policy), pstl::counting_iterator<std::ptrdiff_t>(0), pstl::counting_iterator<std::ptrdiff_t>(rows_),
+				Get<Target>().begin(), evaluate);
+		}
+
+		// Field = op(Field), in place
+		template <typename Field, typename Policy, typename UnaryOp>
+		void Apply(Policy&& policy, UnaryOp op)
+		{
+			auto& column = Get<Field>();
+			algo::transform(std::forward<Policy>(policy), column.begin(), column.end(), column.begin(), op);
+		}
+
+		template <typename Field, typename Policy, typename T, typename BinaryOp>
+		T Reduce(Policy&& policy, T init, BinaryOp reduce) const
+		{
+			const auto& column = Get<Field>();
+			return algo::transform_reduce(std::forward<Policy>(policy), column.begin(), column.end(), init, reduce,
+				[](const typename Field::ValueType& v) { return v; });
+		}
+
+	private:
+		std::size_t rows_ = 0;
+		std::tuple<Column<typename Fields::ValueType>...> columns_;
+	};
+
+	// Column expressions. Bind(table) returns a row-index -> value function object.
+
+	template <typename Field>
+	struct ColumnRef
+	{
+		template <typename Table>
+		auto Bind(const Table& table) const
+		{
+			const auto* data = table.template Get<Field>().data();
+			return [data](std::ptrdiff_t i) { return data[i]; };
+		}
+	};
+
+	template <typename T>
+	struct Constant
+	{
+		T value;
+
+		template <typename Table>
+		auto Bind(const Table&) const
+		{
+			const T v = value;
+			return [v](std::ptrdiff_t) { return v; };
+		}
+	};
+
+	template <typename Op, typename Left, typename Right>
+	struct BinaryExpression
+	{
+		Left left;
+		Right right;
+
+		template <typename Table>
+		auto Bind(const Table& table) const
+		{
+			return [l = left.Bind(table), r = right.Bind(table)](std::ptrdiff_t i) { return Op()(l(i), r(i)); };
+		}
+	};
+
+	template <typename Field>
+	constexpr ColumnRef<Field> Col() { return {}; }
+
+	template <typename T>
+	struct IsExpression : std::false_type {};
+	template <typename Field>
+	struct IsExpression<ColumnRef<Field>> : std::true_type {};
+	template <typename T>
+	struct IsExpression<Constant<T>> : std::true_type {};
+	template <typename Op, typename Left, typename Right>
+	struct IsExpression<BinaryExpression<Op, Left, Right>> : std::true_type {};
+
+	template <typename T>
+	auto AsExpression(const T& operand)
+	{
+		if constexpr (IsExpression<T>::value)
+			return operand;
+		else
+			return Constant<T>{ operand };
+	}
+
+	template <typename Op, typename Left, typename Right>
+	using EnableIfExpression = std::enable_if_t<IsExpression<Left>::value || IsExpression<Right>::value,
+		BinaryExpression<Op, decltype(AsExpression(std::declval<Left>())), decltype(AsExpression(std::declval<Right>()))>>;
+
+	template <typename Left, typename Right>
+	auto operator+(const Left& l, const Right& r) -> EnableIfExpression<std::plus<>, Left, Right> { return { AsExpression(l), AsExpression(r) }; }
+
+	template <typename Left, typename Right>
+	auto operator-(const Left& l, const Right& r) -> EnableIfExpression<std::minus<>, Left, Right> { return { AsExpression(l), AsExpression(r) }; }
+
+	template <typename Left, typename Right>
+	auto operator*(const Left& l, const Right& r) -> EnableIfExpression<std::multiplies<>, Left, Right> { return { AsExpression(l), AsExpression(r) }; }
+
+	template <typename Left, typename Right>
+	auto operator/(const Left& l, const Right& r) -> EnableIfExpression<std::divides<>, Left, Right> { return { AsExpression(l), AsExpression(r) }; }
+}
@@ -0,0 +1,109 @@
+﻿#include <cstdint>
+#include <execution>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/execution>
+#include <pstl/iterators.h>
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+#include "AlgorithmDispatch.h"
+#include "ColumnEncoding.h"
+#include "SalesData.h"
+
+// The profit computation of BM_ProfitColumns on narrower encodings of its inputs
+// (ColumnEncoding.h), decoded inside the kernel:
+//	Uncompressed  double price, uint32 quantity, double discount      20 bytes in
+//	Compact       float price, uint8 quantity, 8-bit fixed discount    6 bytes in
+//	BitPacked     Compact with the quantity frame-of-reference packed in 7 bits
+// Profit is written as double by all three. Once the columns no longer fit in cache the
+// kernel is bandwidth bound, so rows/s should follow bytes/row.
+//
+// Counters: rows (rows per second), bytes/row (input and output column bytes per row).
+
+static void SetRowCounters(benchmark::State& state, std::size_t rows, double bytesPerRow)
+{
+	state.counters["rows"] = benchmark::Counter(static_cast<double>(rows), benchmark::Counter::kIsIterationInvariantRate);
+	state.counters["bytes/row"] = bytesPerRow;
+}
+
+template <typename Policy>
+static void BM_ProfitUncompressed(benchmark::State& state, Policy execution_policy)
+{
+	auto table = GenSalesTable(state.range(0));
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		table.Compute<sales::Profit>(execution_policy, sales::ProfitExpression());
+		benchmark::ClobberMemory();
+	}
+	SetRowCounters(state, table.Rows(), sizeof(double) + sizeof(unsigned int) + sizeof(double) + sizeof(double));
+}
+
+template <typename Policy>
+static void BM_ProfitCompact(benchmark::State& state, Policy execution_policy)
+{
+	auto table = EncodeCompact(GenSalesTable(state.range(0)));
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		table.Compute<sales::Profit>(execution_policy, sales::CompactProfitExpression());
+		benchmark::ClobberMemory();
+	}
+	SetRowCounters(state, table.Rows(), sizeof(float) + sizeof(std::uint8_t) + sizeof(std::uint8_t) + sizeof(double));
+}
+
+template <typename Policy>
+static void BM_ProfitBitPacked(benchmark::State& state, Policy execution_policy)
+{
+	const auto source = GenSalesTable(state.range(0));
+	auto table = EncodeCompact(source);
+	const BitPackedColumn quantities(source.Get<sales::Quantity>().begin(), source.Get<sales::Quantity>().end());
+	const float* prices = table.Get<sales::PriceF32>().data();
+	const std::uint8_t* discounts = table.Get<sales::DiscountQ8>().data();
+	const float discountStep = sales::DiscountCode.step;
+	const auto rows = static_cast<int64_t>(table.Rows());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		algo::transform(execution_policy, pstl::counting_iterator<int64_t>(0), pstl::counting_iterator<int64_t>(rows),
+			table.Get<sales::Profit>().begin(), [prices, discounts, discountStep, &quantities](int64_t i) {
+			return (prices[i] * (1.0f - discounts[i] * discountStep)) * static_cast<float>(quantities.Get(i));
+		});
+		benchmark::ClobberMemory();
+	}
+	SetRowCounters(state, table.Rows(), sizeof(float) + quantities.Bits() / 8.0 + sizeof(std::uint8_t) + sizeof(double));
+}
+
+BENCHMARK_CAPTURE(BM_ProfitUncompressed, std_seq, std::execution::seq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitUncompressed, std_par, std::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitUncompressed, std_par_unseq, std::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitUncompressed, pstl_seq, pstl::execution::seq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitUncompressed, pstl_unseq, pstl::execution::unseq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitUncompressed, pstl_par, pstl::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitUncompressed, pstl_par_unseq, pstl::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitUncompressed, threads_par, threaded::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_ProfitCompact, std_seq, std::execution::seq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitCompact, std_par, std::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitCompact, std_par_unseq, std::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitCompact, pstl_seq, pstl::execution::seq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitCompact, pstl_unseq, pstl::execution::unseq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitCompact, pstl_par, pstl::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitCompact, pstl_par_unseq, pstl::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitCompact, threads_par, threaded::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_ProfitBitPacked, std_seq, std::execution::seq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitBitPacked, std_par, std::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitBitPacked, std_par_unseq, std::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitBitPacked, pstl_seq, pstl::execution::seq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitBitPacked, pstl_unseq, pstl::execution::unseq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitBitPacked, pstl_par, pstl::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitBitPacked, pstl_par_unseq, pstl::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitBitPacked, threads_par, threaded::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,282 @@
+﻿#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/execution>
+#include <pstl/iterators.h>
+#include <pstl/numeric>
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+#include "AlgorithmDispatch.h"
+#include "HashTable.h"
+#include "RandomGen.h"
+
+// Building and probing a key -> row map from many threads at once, three ways:
+//	Concurrent  ConcurrentHashMap (HashTable.h), CAS inserts from for_each
+//	SortUnique  (key, row) pairs sorted by key, duplicates dropped with unique, looked up
+//	            by binary search
+//	Sharded     std::unordered_map per shard behind a std::mutex, the shard picked by
+//	            the key hash
+// The benchmark argument is the slot count of the concurrent table, the kernel name
+// carries its load factor: BM_ConcurrentInsert<75%>/pstl_par/4194304 inserts
+// 0.75 * 4194304 random keys, and the baselines get the same keys. The lookups are
+// as many, half of them hits. Thread counts come from the driver's --threads.
+//
+// Counters: keys (keys inserted or looked up per second), load (of the concurrent table).
+
+using MapKey = std::uint32_t;
+using MapRow = std::uint32_t;
+
+static std::vector<MapKey> GenMapKeys(std::size_t count)
+{
+	std::vector<MapKey> keys(count);
+	std::generate(keys.begin(), keys.end(), []() {
+		MapKey key;
+		do
+			key = GenRandomKey<MapKey>();
+		while (key == ConcurrentHashMap<MapKey, MapRow>::EmptyKey);
+		return key;
+	});
+	return keys;
+}
+
+// every other lookup is an inserted key, the rest are fresh random keys
+static std::vector<MapKey> GenLookupKeys(const std::vector<MapKey>& inserted)
+{
+	auto lookups = GenMapKeys(inserted.size());
+	for (std::size_t i = 0; i < lookups.size(); i += 2)
+		lookups[i] = inserted[(i * 7919) % inserted.size()];
+	std::shuffle(lookups.begin(), lookups.end(), std::mt19937_64());
+	return lookups;
+}
+
+static std::size_t KeyCount(benchmark::State& state, int loadPercent)
+{
+	return static_cast<std::size_t>(state.range(0)) * loadPercent / 100;
+}
+
+static void SetMapCounters(benchmark::State& state, std::size_t keys, std::size_t capacity)
+{
+	state.counters["keys"] = benchmark::Counter(static_cast<double>(keys), benchmark::Counter::kIsIterationInvariantRate);
+	state.counters["load"] = static_cast<double>(keys) / capacity;
+}
+
+template <typename Policy>
+static void BM_ConcurrentInsert(benchmark::State& state, int loadPercent, Policy execution_policy)
+{
+	const auto keys = GenMapKeys(KeyCount(state, loadPercent));
+	std::size_t capacity = 0;
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		ConcurrentHashMap<MapKey, MapRow> map(execution_policy, keys.size(), loadPercent / 100.0);
+		algo::for_each(execution_policy, pstl::counting_iterator<MapRow>(0), pstl::counting_iterator<MapRow>(static_cast<MapRow>(keys.size())),
+			[&map, &keys](MapRow row) { map.Insert(keys[row], row); });
+		capacity = map.Capacity();
+		benchmark::ClobberMemory();
+	}
+	SetMapCounters(state, keys.size(), capacity);
+}
+
+template <typename Policy>
+static void BM_ConcurrentLookup(benchmark::State& state, int loadPercent, Policy execution_policy)
+{
+	const auto keys = GenMapKeys(KeyCount(state, loadPercent));
+	const auto lookups = GenLookupKeys(keys);
+	ConcurrentHashMap<MapKey, MapRow> map(execution_policy, keys.size(), loadPercent / 100.0);
+	algo::for_each(execution_policy, pstl::counting_iterator<MapRow>(0), pstl::counting_iterator<MapRow>(static_cast<MapRow>(keys.size())),
+		[&map, &keys](MapRow row) { map.Insert(keys[row], row); });
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::size_t hits = algo::transform_reduce(execution_policy, lookups.begin(), lookups.end(), std::size_t(0), std::plus<std::size_t>(),
+			[&map](MapKey key) { return map.Find(key) ? std::size_t(1) : std::size_t(0); });
+		benchmark::DoNotOptimize(hits);
+	}
+	SetMapCounters(state, lookups.size(), map.Capacity());
+}
+
+// key in the high half, so the sort orders by key and keeps the first row of a key first
+static std::uint64_t PackKeyRow(MapKey key, MapRow row)
+{
+	return (static_cast<std::uint64_t>(key) << 32) | row;
+}
+
+static bool SameKey(std::uint64_t a, std::uint64_t b)
+{
+	return (a >> 32) == (b >> 32);
+}
+
+template <typename Policy>
+static std::vector<std::uint64_t> SortUniqueBuild(Policy&& policy, const std::vector<MapKey>& keys)
+{
+	std::vector<std::uint64_t> map(keys.size());
+	algo::transform(policy, pstl::counting_iterator<MapRow>(0), pstl::counting_iterator<MapRow>(static_cast<MapRow>(keys.size())),
+		map.begin(), [&keys](MapRow row) { return PackKeyRow(keys[row], row); });
+	algo::sort(policy, map.begin(), map.end());
+	map.erase(algo::unique(policy, map.begin(), map.end(), SameKey), map.end());
+	return map;
+}
+
+template <typename Policy>
+static void BM_SortUniqueInsert(benchmark::State& state, int loadPercent, Policy execution_policy)
+{
+	const auto keys = GenMapKeys(KeyCount(state, loadPercent));
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		auto map = SortUniqueBuild(execution_policy, keys);
+		benchmark::DoNotOptimize(map.data());
+	}
+	SetMapCounters(state, keys.size(), state.range(0));
+}
+
+template <typename Policy>
+static void BM_SortUniqueLookup(benchmark::State& state, int loadPercent, Policy execution_policy)
+{
+	const auto keys = GenMapKeys(KeyCount(state, loadPercent));
+	const auto lookups = GenLookupKeys(keys);
+	const auto map = SortUniqueBuild(execution_policy, keys);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::size_t hits = algo::transform_reduce(execution_policy, lookups.begin(), lookups.end(), std::size_t(0), std::plus<std::size_t>(),
+			[&map](MapKey key) {
+			const auto found = std::lower_bound(map.begin(), map.end(), PackKeyRow(key, 0));
+			return found != map.end() && (*found >> 32) == key ? std::size_t(1) : std::size_t(0);
+		});
+		benchmark::DoNotOptimize(hits);
+	}
+	SetMapCounters(state, lookups.size(), state.range(0));
+}
+
+// the usual way to share a standard container between threads
+class ShardedHashMap
+{
+public:
+	static constexpr std::size_t Shards = 64;
+
+	explicit ShardedHashMap(std::size_t expectedSize)
+	{
+		for (auto& shard : shards_)
+			shard.map.reserve(expectedSize / Shards);
+	}
+
+	bool Insert(MapKey key, MapRow row)
+	{
+		auto& shard = ShardOf(key);
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		return shard.map.emplace(key, row).second;
+	}
+
+	bool Contains(MapKey key)
+	{
+		auto& shard = ShardOf(key);
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		return shard.map.count(key) != 0;
+	}
+
+private:
+	// padded so that two shards' locks never share a cache line
+	struct alignas(64) Shard
+	{
+		std::mutex mutex;
+		std::unordered_map<MapKey, MapRow> map;
+	};
+
+	Shard& ShardOf(MapKey key) { return shards_[HashKey(key) >> 58]; }
+
+	Shard shards_[Shards];
+};
+
+template <typename Policy>
+static void BM_ShardedInsert(benchmark::State& state, int loadPercent, Policy execution_policy)
+{
+	const auto keys = GenMapKeys(KeyCount(state, loadPercent));
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		ShardedHashMap map(keys.size());
+		algo::for_each(execution_policy, pstl::counting_iterator<MapRow>(0), pstl::counting_iterator<MapRow>(static_cast<MapRow>(keys.size())),
+			[&map, &keys](MapRow row) { map.Insert(keys[row], row); });
+		benchmark::ClobberMemory();
+	}
+	SetMapCounters(state, keys.size(), state.range(0));
+}
+
+template <typename Policy>
+static void BM_ShardedLookup(benchmark::State& state, int loadPercent, Policy execution_policy)
+{
+	const auto keys = GenMapKeys(KeyCount(state, loadPercent));
+	const auto lookups = GenLookupKeys(keys);
+	ShardedHashMap map(keys.size());
+	for (MapRow row = 0; row < keys.size(); ++row)
+		map.Insert(keys[row], row);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::size_t hits = algo::transform_reduce(execution_policy, lookups.begin(), lookups.end(), std::size_t(0), std::plus<std::size_t>(),
+			[&map](MapKey key) { return map.Contains(key) ? std::size_t(1) : std::size_t(0); });
+		benchmark::DoNotOptimize(hits);
+	}
+	SetMapCounters(state, lookups.size(), state.range(0));
+}
+
+// The load factor goes into the kernel name: BM_ShardedLookup<50%>/pstl_par/262144.
+template <typename Kernel>
+static void RegisterHashMapBenchmark(const std::string& name, int loadPercent, const std::string& policyName, Kernel kernel)
+{
+	benchmark::RegisterBenchmark((name + "<" + std::to_string(loadPercent) + "%>/" + policyName).c_str(),
+		[loadPercent, kernel](benchmark::State& state) { kernel(state, loadPercent); })
+		->RangeMultiplier(8)->Range(1 << 16, 1 << 22)->Unit(benchmark::kMillisecond);
+}
+
+template <typename Policy>
+static void RegisterHashMapBenchmarks(int loadPercent, const std::string& policyName, Policy policy)
+{
+	RegisterHashMapBenchmark("BM_ConcurrentInsert", loadPercent, policyName,
+		[policy](benchmark::State& state, int load) { BM_ConcurrentInsert(state, load, policy); });
+	RegisterHashMapBenchmark("BM_ConcurrentLookup", loadPercent, policyName,
+		[policy](benchmark::State& state, int load) { BM_ConcurrentLookup(state, load, policy); });
+	RegisterHashMapBenchmark("BM_ShardedInsert", loadPercent, policyName,
+		[policy](benchmark::State& state, int load) { BM_ShardedInsert(state, load, policy); });
+	RegisterHashMapBenchmark("BM_ShardedLookup", loadPercent, policyName,
+		[policy](benchmark::State& state, int load) { BM_ShardedLookup(state, load, policy); });
+	RegisterHashMapBenchmark("BM_SortUniqueInsert", loadPercent, policyName,
+		[policy](benchmark::State& state, int load) { BM_SortUniqueInsert(state, load, policy); });
+	RegisterHashMapBenchmark("BM_SortUniqueLookup", loadPercent, policyName,
+		[policy](benchmark::State& state, int load) { BM_SortUniqueLookup(state, load, policy); });
+}
+
+// CAS and locks are not vectorisable, so seq and par only
+static void RegisterConcurrentHashBenchmarks(int loadPercent)
+{
+	RegisterHashMapBenchmarks(loadPercent, "std_seq", std::execution::seq);
+	RegisterHashMapBenchmarks(loadPercent, "std_par", std::execution::par);
+	RegisterHashMapBenchmarks(loadPercent, "pstl_seq", pstl::execution::seq);
+	RegisterHashMapBenchmarks(loadPercent, "pstl_par", pstl::execution::par);
+	RegisterHashMapBenchmarks(loadPercent, "threads_par", threaded::execution::par);
+}
+
+static const bool ConcurrentHashBenchmarksRegistered = []() {
+	for (int loadPercent : { 25, 50, 75, 90 })
+		RegisterConcurrentHashBenchmarks(loadPercent);
+	return true;
+}();
@@ -0,0 +1,206 @@
+﻿#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/numeric>
+#include <pstl/execution>
+#include <pstl/iterators.h>
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+#include "../Common/EnvironmentInfo.h"
+
+#include "AlgorithmDispatch.h"
+#include "RandomGen.h"
+
+// Dense GEMV (y = A * x, n dot products of length n) and cache blocked GEMM
+// (C += A * B) built from standard algorithms only, for float and double, n x n
+// row-major matrices. Both report FLOP/s and "peak", the fraction of the estimated
+// peak of the cores the policy may use:
+//	physical cores * base clock * 2 FMA ports * 2 flops * SIMD lanes of the build
+// which is a rough ceiling (no turbo, assumes two FMA units) - good enough to tell
+// 5% from 50%, not to rank against a vendor BLAS.
+
+// SIMD register width the compiler was allowed to use
+constexpr int SimdBytes =
+#if defined(__AVX512F__)
+	64;
+#elif defined(__AVX__)
+	32;
+#else
+	16;
+#endif
+
+template <typename T>
+static double EstimatePeakFlops(std::ptrdiff_t cores)
+{
+	double mhz = ReadBaseFrequencyMHz();
+	if (mhz <= 0.0)
+	{
+		const auto frequencies = ReadCoreFrequenciesMHz();
+		if (!frequencies.empty())
+			mhz = std::accumulate(frequencies.begin(), frequencies.end(), 0.0) / frequencies.size();
+	}
+	const double lanes = static_cast<double>(SimdBytes / sizeof(T));
+	return cores * mhz * 1.0e6 * 2.0 * 2.0 * lanes;
+}
+
+template <typename T, typename Policy>
+static void SetFlopCounters(benchmark::State& state, double flopsPerIteration)
+{
+	state.counters["FLOP"] = benchmark::Counter(flopsPerIteration, benchmark::Counter::kIsIterationInvariantRate);
+
+	// SMT siblings share the FMA units, so at most one worker per physical core counts
+	std::ptrdiff_t cores = threaded::WorkerCount();
+	if (PhysicalCoreCount() > 0)
+		cores = std::min<std::ptrdiff_t>(cores, PhysicalCoreCount());
+	const double peak = EstimatePeakFlops<T>(algo::IsSequential<Policy> ? 1 : cores);
+	if (peak > 0.0)
+		state.counters["peak"] = benchmark::Counter(flopsPerIteration / peak, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template <typename T>
+static std::vector<T> GenRandomMatrix(std::int64_t n)
+{
+	std::vector<T> m(n * n);
+	std::generate(m.begin(), m.end(), []() { return static_cast<T>(GenRandomFloat(-1.0f, 1.0f)); });
+	return m;
+}
+
+template <typename T, typename Policy>
+static void BM_Gemv(benchmark::State& state, Policy execution_policy)
+{
+	const auto n = state.range(0);
+	const auto a = GenRandomMatrix<T>(n);
+	std::vector<T> x(n), y(n);
+	std::generate(x.begin(), x.end(), []() { return static_cast<T>(GenRandomFloat(-1.0f, 1.0f)); });
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		// rows in parallel, every row is a BM_DotProduct with the vectorised pstl overload
+		algo::for_each(execution_policy, pstl::counting_iterator<std::int64_t>(0), pstl::counting_iterator<std::int64_t>(n),
+			[&a, &x, &y, n](std::int64_t row) {
+			const auto rowBegin = a.begin() + row * n;
+			y[row] = std::transform_reduce(pstl::execution::unseq, rowBegin, rowBegin + n, x.begin(), T(0));
+		});
+		benchmark::ClobberMemory();
+	}
+
+	SetFlopCounters<T, Policy>(state, 2.0 * n * n);
+	state.SetBytesProcessed(state.iterations() * (n * n + 2 * n) * static_cast<int64_t>(sizeof(T)));
+}
+
+// Register blocking of the GEMM micro-kernel: MicroRows x MicroCols accumulators, the
+// inner loop over MicroCols contiguous B / C elements is what the compiler vectorises.
+constexpr std::int64_t MicroRows = 4;
+constexpr std::int64_t MicroCols = 16;
+
+// Cache blocking: a BlockRows x BlockCols tile of C is one parallel work item, and the
+// K dimension is walked in BlockDepth steps so the A and B panels stay in L2.
+constexpr std::int64_t BlockRows = 64;
+constexpr std::int64_t BlockCols = 256;
+constexpr std::int64_t BlockDepth = 256;
+
+// C[0..MicroRows) x [0..MicroCols) += A[.., k0..k1) * B[k0..k1, ..), all row-major with stride n
+template <typename T>
+static void GemmMicroKernel(const T* a, const T* b, T* c, std::int64_t n, std::int64_t depth)
+{
+	T acc[MicroRows][MicroCols];
+	for (std::int64_t i = 0; i < MicroRows; ++i)
+		for (std::int64_t j = 0; j < MicroCols; ++j)
+			acc[i][j] = c[i * n + j];
+
+	for (std::int64_t k = 0; k < depth; ++k)
+	{
+		const T* bRow = b + k * n;
+		for (std::int64_t i = 0; i < MicroRows; ++i)
+		{
+			const T aik = a[i * n + k];
+			for (std::int64_t j = 0; j < MicroCols; ++j)
+				acc[i][j] += aik * bRow[j];
+		}
+	}
+
+	for (std::int64_t i = 0; i < MicroRows; ++i)
+		for (std::int64_t j = 0; j < MicroCols; ++j)
+			c[i * n + j] = acc[i][j];
+}
+
+template <typename T, typename Policy>
+static void BM_Gemm(benchmark::State& state, Policy execution_policy)
+{
+	const auto n = state.range(0);
+	if (n % MicroRows != 0 || n % MicroCols != 0)
+	{
+		state.SkipWithError("n must be a multiple of the micro-kernel size");
+		return;
+	}
+
+	const auto a = GenRandomMatrix<T>(n);
+	const auto b = GenRandomMatrix<T>(n);
+	std::vector<T> c(n * n);
+
+	const auto tileRows = (n + BlockRows - 1) / BlockRows;
+	const auto tileCols = (n + BlockCols - 1) / BlockCols;
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::fill(c.begin(), c.end(), T(0));
+		algo::for_each(execution_policy, pstl::counting_iterator<std::int64_t>(0), pstl::counting_iterator<std::int64_t>(tileRows * tileCols),
+			[&a, &b, &c, n, tileCols](std::int64_t tile) {
+			const auto i0 = (tile / tileCols) * BlockRows, i1 = std::min(i0 + BlockRows, n);
+			const auto j0 = (tile % tileCols) * BlockCols, j1 = std::min(j0 + BlockCols, n);
+			for (std::int64_t k0 = 0; k0 < n; k0 += BlockDepth)
+			{
+				const auto depth = std::min(BlockDepth, n - k0);
+				for (std::int64_t i = i0; i < i1; i += MicroRows)
+					for (std::int64_t j = j0; j < j1; j += MicroCols)
+						GemmMicroKernel(&a[i * n + k0], &b[k0 * n + j], &c[i * n + j], n, depth);
+			}
+		});
+		benchmark::ClobberMemory();
+	}
+
+	SetFlopCounters<T, Policy>(state, 2.0 * n * n * n);
+}
+
+// The element type goes into the kernel name: BM_Gemm<float>/pstl_par/512.
+template <typename T, typename Policy>
+static void RegisterDenseMatrixBenchmarks(const std::string& typeName, const std::string& policyName, Policy policy)
+{
+	const std::string suffix = "<" + typeName + ">/" + policyName;
+	benchmark::RegisterBenchmark(("BM_Gemv" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_Gemv<T>(state, policy); })
+		->RangeMultiplier(2)->Range(256, 4096)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_Gemm" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_Gemm<T>(state, policy); })
+		->RangeMultiplier(2)->Range(64, 1024)->Unit(benchmark::kMicrosecond);
+}
+
+template <typename T>
+static void RegisterDenseMatrixBenchmarks(const std::string& typeName)
+{
+	RegisterDenseMatrixBenchmarks<T>(typeName, "std_seq", std::execution::seq);
+	RegisterDenseMatrixBenchmarks<T>(typeName, "std_par", std::execution::par);
+	RegisterDenseMatrixBenchmarks<T>(typeName, "std_par_unseq", std::execution::par_unseq);
+	RegisterDenseMatrixBenchmarks<T>(typeName, "pstl_seq", pstl::execution::seq);
+	RegisterDenseMatrixBenchmarks<T>(typeName, "pstl_unseq", pstl::execution::unseq);
+	RegisterDenseMatrixBenchmarks<T>(typeName, "pstl_par", pstl::execution::par);
+	RegisterDenseMatrixBenchmarks<T>(typeName, "pstl_par_unseq", pstl::execution::par_unseq);
+	RegisterDenseMatrixBenchmarks<T>(typeName, "threads_par", threaded::execution::par);
+}
+
+static const bool DenseMatrixBenchmarksRegistered = []() {
+	RegisterDenseMatrixBenchmarks<float>("float");
+	RegisterDenseMatrixBenchmarks<double>("double");
+	return true;
+}();
@@ -0,0 +1,113 @@
+﻿#include <algorithm>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/numeric>
+#include <pstl/execution>
+
+#include "benchmark/benchmark.h"
+
+#include "AlgorithmDispatch.h"
+
+// Fixed cost of calling an algorithm with a parallel policy: trivial bodies over
+// tiny ranges, so the time is dominated by policy dispatch, task creation and joining.
+// These floors explain the small-N results of the other kernels and give the
+// minimum batch size worth handing to par / par_unseq. threads_par spawns and joins
+// std::threads on every call, one per threaded::MinChunkSize elements at most, so
+// ranges below 2 * MinChunkSize stay on the calling thread.
+
+template <typename Policy>
+static void BM_DispatchForEach(benchmark::State& state, Policy execution_policy)
+{
+	std::vector<int> data(state.range(0), 1);
+
+	for (auto _ : state)
+	{
+		algo::for_each(execution_policy, data.begin(), data.end(), [](int&) {});
+		benchmark::ClobberMemory();
+	}
+}
+
+template <typename Policy>
+static void BM_DispatchTransform(benchmark::State& state, Policy execution_policy)
+{
+	std::vector<int> data(state.range(0), 1);
+	std::vector<int> out(data.size());
+
+	for (auto _ : state)
+	{
+		algo::transform(execution_policy, data.begin(), data.end(), out.begin(), [](int v) { return v; });
+		benchmark::ClobberMemory();
+	}
+}
+
+template <typename Policy>
+static void BM_DispatchReduce(benchmark::State& state, Policy execution_policy)
+{
+	std::vector<int> data(state.range(0), 1);
+
+	for (auto _ : state)
+	{
+		// transform_reduce with an identity transform, threaded:: has no plain reduce
+		int sum = algo::transform_reduce(execution_policy, data.begin(), data.end(), 0, std::plus<int>(), [](int v) { return v; });
+		benchmark::DoNotOptimize(sum);
+	}
+}
+
+template <typename Policy>
+static void BM_DispatchSort(benchmark::State& state, Policy execution_policy)
+{
+	// already sorted after the first iteration, which is the cheapest input for every policy
+	std::vector<int> data(state.range(0));
+	std::iota(data.begin(), data.end(), 0);
+
+	for (auto _ : state)
+	{
+		algo::sort(execution_policy, data.begin(), data.end());
+		benchmark::ClobberMemory();
+	}
+}
+
+BENCHMARK_CAPTURE(BM_DispatchForEach, std_seq, std::execution::seq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchForEach, std_par, std::execution::par)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchForEach, std_par_unseq, std::execution::par_unseq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchForEach, pstl_seq, pstl::execution::seq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchForEach, pstl_unseq, pstl::execution::unseq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchForEach, pstl_par, pstl::execution::par)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchForEach, pstl_par_unseq, pstl::execution::par_unseq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchForEach, threads_par, threaded::execution::par)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+
+BENCHMARK_CAPTURE(BM_DispatchTransform, std_seq, std::execution::seq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchTransform, std_par, std::execution::par)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchTransform, std_par_unseq, std::execution::par_unseq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchTransform, pstl_seq, pstl::execution::seq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchTransform, pstl_unseq, pstl::execution::unseq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchTransform, pstl_par, pstl::execution::par)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchTransform, pstl_par_unseq, pstl::execution::par_unseq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchTransform, threads_par, threaded::execution::par)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+
+BENCHMARK_CAPTURE(BM_DispatchReduce, std_seq, std::execution::seq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchReduce, std_par, std::execution::par)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchReduce, std_par_unseq, std::execution::par_unseq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchReduce, pstl_seq, pstl::execution::seq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchReduce, pstl_unseq, pstl::execution::unseq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchReduce, pstl_par, pstl::execution::par)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchReduce, pstl_par_unseq, pstl::execution::par_unseq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchReduce, threads_par, threaded::execution::par)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+
+// sort has no vectorised variant, unseq would just fall back to seq
+BENCHMARK_CAPTURE(BM_DispatchSort, std_seq, std::execution::seq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchSort, std_par, std::execution::par)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchSort, pstl_seq, pstl::execution::seq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchSort, pstl_par, pstl::execution::par)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchSort, threads_par, threaded::execution::par)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+
+#if defined(__cpp_lib_execution) && __cpp_lib_execution >= 201902L
+// std::execution::unseq is C++20
+BENCHMARK_CAPTURE(BM_DispatchForEach, std_unseq, std::execution::unseq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchTransform, std_unseq, std::execution::unseq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(BM_DispatchReduce, std_unseq, std::execution::unseq)->Arg(0)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+#endif
@@ -0,0 +1,178 @@
+﻿#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/execution>
+#include <pstl/iterators.h>
+#include <pstl/numeric>
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+#include "AlgorithmDispatch.h"
+#include "SalesData.h"
+
+// SELECT SUM(profit) WHERE discount > x AND quantity BETWEEN a AND b over the
+// BM_CountingIter columns, with the predicate evaluated three ways:
+//	Branchy    transform_reduce with an if on the predicate, the sum only touches
+//	           matching rows but every row is a data dependent branch
+//	Masked     transform_reduce adding profit * (predicate as 0/1), no branches,
+//	           always reads the whole profit column
+//	Selection  copy_if of the matching row indices into a selection vector, then a
+//	           transform_reduce gathering profit through it
+// The selectivity in percent is part of the kernel name, as in
+// BM_FilteredSumBranchy<10%>/pstl_par/1000000; both predicates select its square root,
+// so neither is trivially true. Branchy should suffer most around 50%, the selection
+// vector should win at low selectivity.
+//
+// Counters: rows (rows scanned per second), selectivity (measured fraction of matching rows).
+
+struct SalesFilter
+{
+	double minDiscount;
+	unsigned int minQuantity;
+	unsigned int maxQuantity;
+
+	// quantity is uniform over [1, 100] and discount over [0, 0.5)
+	explicit SalesFilter(double selectivity)
+	{
+		const double fraction = std::sqrt(selectivity);
+		const auto width = std::max(1u, static_cast<unsigned int>(std::lround(100.0 * fraction)));
+		minQuantity = 1 + (100 - width) / 2;
+		maxQuantity = minQuantity + width - 1;
+		minDiscount = 0.5 * (1.0 - fraction);
+	}
+
+	bool operator()(unsigned int quantity, double discount) const
+	{
+		return discount > minDiscount && quantity >= minQuantity && quantity <= maxQuantity;
+	}
+
+	// same predicate without short-circuit evaluation
+	double Mask(unsigned int quantity, double discount) const
+	{
+		return static_cast<double>((discount > minDiscount) & (quantity >= minQuantity) & (quantity <= maxQuantity));
+	}
+};
+
+static sales::Table GenFilterTable(std::size_t rows)
+{
+	auto table = GenSalesTable(rows);
+	table.Compute<sales::Profit>(pstl::execution::par, sales::ProfitExpression());
+	return table;
+}
+
+static void SetFilterCounters(benchmark::State& state, const sales::Table& table, const SalesFilter& filter)
+{
+	const auto& quantities = table.Get<sales::Quantity>();
+	const auto& discounts = table.Get<sales::Discount>();
+	std::size_t matching = 0;
+	for (std::size_t i = 0; i < table.Rows(); ++i)
+		matching += filter(quantities[i], discounts[i]) ? 1 : 0;
+
+	state.counters["rows"] = benchmark::Counter(static_cast<double>(table.Rows()), benchmark::Counter::kIsIterationInvariantRate);
+	state.counters["selectivity"] = static_cast<double>(matching) / table.Rows();
+}
+
+template <typename Policy>
+static void BM_FilteredSumBranchy(benchmark::State& state, int selectivity, Policy execution_policy)
+{
+	const auto table = GenFilterTable(state.range(0));
+	const SalesFilter filter(selectivity / 100.0);
+	const auto columns = table.Select<sales::Quantity, sales::Discount, sales::Profit>();
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		double sum = columns.TransformReduce(execution_policy, 0.0, std::plus<double>(),
+			[filter](unsigned int quantity, double discount, double profit) {
+			if (filter(quantity, discount))
+				return profit;
+			return 0.0;
+		});
+		benchmark::DoNotOptimize(sum);
+	}
+	SetFilterCounters(state, table, filter);
+}
+
+template <typename Policy>
+static void BM_FilteredSumMasked(benchmark::State& state, int selectivity, Policy execution_policy)
+{
+	const auto table = GenFilterTable(state.range(0));
+	const SalesFilter filter(selectivity / 100.0);
+	const auto columns = table.Select<sales::Quantity, sales::Discount, sales::Profit>();
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		double sum = columns.TransformReduce(execution_policy, 0.0, std::plus<double>(),
+			[filter](unsigned int quantity, double discount, double profit) {
+			return profit * filter.Mask(quantity, discount);
+		});
+		benchmark::DoNotOptimize(sum);
+	}
+	SetFilterCounters(state, table, filter);
+}
+
+template <typename Policy>
+static void BM_FilteredSumSelection(benchmark::State& state, int selectivity, Policy execution_policy)
+{
+	const auto table = GenFilterTable(state.range(0));
+	const SalesFilter filter(selectivity / 100.0);
+	const unsigned int* quantities = table.Get<sales::Quantity>().data();
+	const double* discounts = table.Get<sales::Discount>().data();
+	const double* profit = table.Get<sales::Profit>().data();
+	const auto rows = static_cast<std::uint32_t>(table.Rows());
+	std::vector<std::uint32_t> selection(rows);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		const auto selectionEnd = algo::copy_if(execution_policy, pstl::counting_iterator<std::uint32_t>(0), pstl::counting_iterator<std::uint32_t>(rows),
+			selection.begin(), [filter, quantities, discounts](std::uint32_t i) { return filter(quantities[i], discounts[i]); });
+
+		double sum = algo::transform_reduce(execution_policy, selection.begin(), selectionEnd, 0.0, std::plus<double>(),
+			[profit](std::uint32_t i) { return profit[i]; });
+		benchmark::DoNotOptimize(sum);
+	}
+	SetFilterCounters(state, table, filter);
+}
+
+template <typename Policy>
+static void RegisterFilteredSumBenchmarks(int selectivity, const std::string& policyName, Policy policy)
+{
+	const std::string suffix = "<" + std::to_string(selectivity) + "%>/" + policyName;
+	benchmark::RegisterBenchmark(("BM_FilteredSumBranchy" + suffix).c_str(),
+		[selectivity, policy](benchmark::State& state) { BM_FilteredSumBranchy(state, selectivity, policy); })
+		->RangeMultiplier(10)->Range(1000000, 10000000)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_FilteredSumMasked" + suffix).c_str(),
+		[selectivity, policy](benchmark::State& state) { BM_FilteredSumMasked(state, selectivity, policy); })
+		->RangeMultiplier(10)->Range(1000000, 10000000)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_FilteredSumSelection" + suffix).c_str(),
+		[selectivity, policy](benchmark::State& state) { BM_FilteredSumSelection(state, selectivity, policy); })
+		->RangeMultiplier(10)->Range(1000000, 10000000)->Unit(benchmark::kMicrosecond);
+}
+
+static void RegisterFilteredSumBenchmarks(int selectivity)
+{
+	RegisterFilteredSumBenchmarks(selectivity, "std_seq", std::execution::seq);
+	RegisterFilteredSumBenchmarks(selectivity, "std_par", std::execution::par);
+	RegisterFilteredSumBenchmarks(selectivity, "std_par_unseq", std::execution::par_unseq);
+	RegisterFilteredSumBenchmarks(selectivity, "pstl_seq", pstl::execution::seq);
+	RegisterFilteredSumBenchmarks(selectivity, "pstl_unseq", pstl::execution::unseq);
+	RegisterFilteredSumBenchmarks(selectivity, "pstl_par", pstl::execution::par);
+	RegisterFilteredSumBenchmarks(selectivity, "pstl_par_unseq", pstl::execution::par_unseq);
+	RegisterFilteredSumBenchmarks(selectivity, "threads_par", threaded::execution::par);
+}
+
+static const bool FilteredSumBenchmarksRegistered = []() {
+	for (int selectivity : { 1, 10, 50, 90, 100 })
+		RegisterFilteredSumBenchmarks(selectivity);
+	return true;
+}();
@@ -0,0 +1,298 @@
+﻿#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/execution>
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+#include "AlgorithmDispatch.h"
+#include "FlatSet.h"
+#include "RandomGen.h"
+
+// FlatSet and FlatMap (FlatSet.h) against std::set and std::map as a read-mostly index
+// of random 32-bit keys, the maps from key to row number: build time from an unsorted
+// batch, lookups per second and bytes per key. std::set / std::map are built by single
+// threaded inserts; their lookups, like the flat ones, are a transform over a batch of
+// LookupCount queries, half of them hits.
+//
+// Counters: keys (keys inserted per second) or lookups (queries per second), and
+// bytes/key (memory of the index per distinct key, std::set through CountingAllocator).
+
+using IndexKey = std::uint32_t;
+using IndexRow = std::uint32_t;
+
+constexpr std::size_t LookupCount = 1 << 20;
+
+// Counts the bytes a container has allocated, node headers included.
+template <typename T>
+struct CountingAllocator
+{
+	using value_type = T;
+
+	explicit CountingAllocator(std::size_t* bytes) : bytes_(bytes) {}
+	template <typename U>
+	CountingAllocator(const CountingAllocator<U>& other) : bytes_(other.bytes_) {}
+
+	T* allocate(std::size_t n)
+	{
+		*bytes_ += n * sizeof(T);
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate(T* p, std::size_t n)
+	{
+		*bytes_ -= n * sizeof(T);
+		std::allocator<T>().deallocate(p, n);
+	}
+
+	template <typename U>
+	bool operator==(const CountingAllocator<U>& other) const { return bytes_ == other.bytes_; }
+	template <typename U>
+	bool operator!=(const CountingAllocator<U>& other) const { return bytes_ != other.bytes_; }
+
+	std::size_t* bytes_;
+};
+
+using StdIndex = std::set<IndexKey, std::less<IndexKey>, CountingAllocator<IndexKey>>;
+using StdRowIndex = std::map<IndexKey, IndexRow, std::less<IndexKey>, CountingAllocator<std::pair<const IndexKey, IndexRow>>>;
+constexpr IndexRow MissingRow = std::numeric_limits<IndexRow>::max();
+
+static std::vector<IndexKey> GenIndexKeys(std::size_t count)
+{
+	std::vector<IndexKey> keys(count);
+	std::generate(keys.begin(), keys.end(), []() { return GenRandomKey<IndexKey>(); });
+	return keys;
+}
+
+// (key, row number) pairs
+static std::vector<std::pair<IndexKey, IndexRow>> GenIndexEntries(const std::vector<IndexKey>& keys)
+{
+	std::vector<std::pair<IndexKey, IndexRow>> entries(keys.size());
+	for (std::size_t i = 0; i < keys.size(); ++i)
+		entries[i] = { keys[i], static_cast<IndexRow>(i) };
+	return entries;
+}
+
+// every other query is an indexed key, the rest are (almost certainly) misses
+static std::vector<IndexKey> GenQueries(const std::vector<IndexKey>& keys)
+{
+	auto queries = GenIndexKeys(LookupCount);
+	for (std::size_t i = 0; i < queries.size(); i += 2)
+		queries[i] = keys[(i * 7919) % keys.size()];
+	std::shuffle(queries.begin(), queries.end(), std::mt19937_64());
+	return queries;
+}
+
+template <typename Policy>
+static void BM_FlatSetBuild(benchmark::State& state, Policy execution_policy)
+{
+	const auto keys = GenIndexKeys(state.range(0));
+	std::size_t bytes = 0, size = 1;
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		auto index = FlatSet<IndexKey>::Build(execution_policy, keys);
+		bytes = index.MemoryBytes();
+		size = index.Size();
+		benchmark::DoNotOptimize(index.Keys().data());
+	}
+	state.counters["keys"] = benchmark::Counter(static_cast<double>(keys.size()), benchmark::Counter::kIsIterationInvariantRate);
+	state.counters["bytes/key"] = static_cast<double>(bytes) / size;
+}
+
+static void BM_StdSetBuild(benchmark::State& state)
+{
+	const auto keys = GenIndexKeys(state.range(0));
+	std::size_t bytes = 0;
+	double bytesPerKey = 0.0;
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		StdIndex index(keys.begin(), keys.end(), std::less<IndexKey>(), CountingAllocator<IndexKey>(&bytes));
+		bytesPerKey = static_cast<double>(bytes) / index.size();
+		benchmark::DoNotOptimize(index.begin());
+	}
+	state.counters["keys"] = benchmark::Counter(static_cast<double>(keys.size()), benchmark::Counter::kIsIterationInvariantRate);
+	state.counters["bytes/key"] = bytesPerKey;
+}
+
+template <typename Policy>
+static void BM_FlatSetLookup(benchmark::State& state, Policy execution_policy)
+{
+	const auto keys = GenIndexKeys(state.range(0));
+	const auto queries = GenQueries(keys);
+	const auto index = FlatSet<IndexKey>::Build(pstl::execution::par, keys);
+	std::vector<char> found(queries.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		index.Contains(execution_policy, queries.begin(), queries.end(), found.begin());
+		benchmark::ClobberMemory();
+	}
+	state.counters["lookups"] = benchmark::Counter(static_cast<double>(queries.size()), benchmark::Counter::kIsIterationInvariantRate);
+	state.counters["bytes/key"] = static_cast<double>(index.MemoryBytes()) / index.Size();
+}
+
+template <typename Policy>
+static void BM_StdSetLookup(benchmark::State& state, Policy execution_policy)
+{
+	const auto keys = GenIndexKeys(state.range(0));
+	const auto queries = GenQueries(keys);
+	std::size_t bytes = 0;
+	const StdIndex index(keys.begin(), keys.end(), std::less<IndexKey>(), CountingAllocator<IndexKey>(&bytes));
+	std::vector<char> found(queries.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		algo::transform(execution_policy, queries.begin(), queries.end(), found.begin(),
+			[&index](IndexKey key) { return index.count(key) != 0; });
+		benchmark::ClobberMemory();
+	}
+	state.counters["lookups"] = benchmark::Counter(static_cast<double>(queries.size()), benchmark::Counter::kIsIterationInvariantRate);
+	state.counters["bytes/key"] = static_cast<double>(bytes) / index.size();
+}
+
+template <typename Policy>
+static void BM_FlatMapBuild(benchmark::State& state, Policy execution_policy)
+{
+	const auto entries = GenIndexEntries(GenIndexKeys(state.range(0)));
+	std::size_t bytes = 0, size = 1;
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		auto index = FlatMap<IndexKey, IndexRow>::Build(execution_policy, entries);
+		bytes = index.MemoryBytes();
+		size = index.Size();
+		benchmark::DoNotOptimize(index);
+	}
+	state.counters["keys"] = benchmark::Counter(static_cast<double>(entries.size()), benchmark::Counter::kIsIterationInvariantRate);
+	state.counters["bytes/key"] = static_cast<double>(bytes) / size;
+}
+
+static void BM_StdMapBuild(benchmark::State& state)
+{
+	const auto entries = GenIndexEntries(GenIndexKeys(state.range(0)));
+	std::size_t bytes = 0;
+	double bytesPerKey = 0.0;
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		StdRowIndex index(entries.begin(), entries.end(), std::less<IndexKey>(), StdRowIndex::allocator_type(&bytes));
+		bytesPerKey = static_cast<double>(bytes) / index.size();
+		benchmark::DoNotOptimize(index.begin());
+	}
+	state.counters["keys"] = benchmark::Counter(static_cast<double>(entries.size()), benchmark::Counter::kIsIterationInvariantRate);
+	state.counters["bytes/key"] = bytesPerKey;
+}
+
+template <typename Policy>
+static void BM_FlatMapLookup(benchmark::State& state, Policy execution_policy)
+{
+	const auto keys = GenIndexKeys(state.range(0));
+	const auto queries = GenQueries(keys);
+	const auto index = FlatMap<IndexKey, IndexRow>::Build(pstl::execution::par, GenIndexEntries(keys));
+	std::vector<IndexRow> rows(queries.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		index.Find(execution_policy, queries.begin(), queries.end(), rows.begin(), MissingRow);
+		benchmark::ClobberMemory();
+	}
+	state.counters["lookups"] = benchmark::Counter(static_cast<double>(queries.size()), benchmark::Counter::kIsIterationInvariantRate);
+	state.counters["bytes/key"] = static_cast<double>(index.MemoryBytes()) / index.Size();
+}
+
+template <typename Policy>
+static void BM_StdMapLookup(benchmark::State& state, Policy execution_policy)
+{
+	const auto keys = GenIndexKeys(state.range(0));
+	const auto queries = GenQueries(keys);
+	const auto entries = GenIndexEntries(keys);
+	std::size_t bytes = 0;
+	const StdRowIndex index(entries.begin(), entries.end(), std::less<IndexKey>(), StdRowIndex::allocator_type(&bytes));
+	std::vector<IndexRow> rows(queries.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		algo::transform(execution_policy, queries.begin(), queries.end(), rows.begin(), [&index](IndexKey key) {
+			const auto it = index.find(key);
+			return it != index.end() ? it->second : MissingRow;
+		});
+		benchmark::ClobberMemory();
+	}
+	state.counters["lookups"] = benchmark::Counter(static_cast<double>(queries.size()), benchmark::Counter::kIsIterationInvariantRate);
+	state.counters["bytes/key"] = static_cast<double>(bytes) / index.size();
+}
+
+// sort + unique build: seq and par only
+BENCHMARK_CAPTURE(BM_FlatSetBuild, std_seq, std::execution::seq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatSetBuild, std_par, std::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatSetBuild, pstl_seq, pstl::execution::seq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatSetBuild, pstl_par, pstl::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatSetBuild, threads_par, threaded::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StdSetBuild)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_FlatSetLookup, std_seq, std::execution::seq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatSetLookup, std_par, std::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatSetLookup, std_par_unseq, std::execution::par_unseq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatSetLookup, pstl_seq, pstl::execution::seq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatSetLookup, pstl_unseq, pstl::execution::unseq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatSetLookup, pstl_par, pstl::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatSetLookup, pstl_par_unseq, pstl::execution::par_unseq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatSetLookup, threads_par, threaded::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_StdSetLookup, std_seq, std::execution::seq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_StdSetLookup, std_par, std::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_StdSetLookup, std_par_unseq, std::execution::par_unseq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_StdSetLookup, pstl_seq, pstl::execution::seq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_StdSetLookup, pstl_unseq, pstl::execution::unseq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_StdSetLookup, pstl_par, pstl::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_StdSetLookup, pstl_par_unseq, pstl::execution::par_unseq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_StdSetLookup, threads_par, threaded::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+
+// stable_sort + unique build: seq and par only
+BENCHMARK_CAPTURE(BM_FlatMapBuild, std_seq, std::execution::seq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatMapBuild, std_par, std::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatMapBuild, pstl_seq, pstl::execution::seq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatMapBuild, pstl_par, pstl::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatMapBuild, threads_par, threaded::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StdMapBuild)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_FlatMapLookup, std_seq, std::execution::seq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatMapLookup, std_par, std::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatMapLookup, std_par_unseq, std::execution::par_unseq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatMapLookup, pstl_seq, pstl::execution::seq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatMapLookup, pstl_unseq, pstl::execution::unseq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatMapLookup, pstl_par, pstl::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatMapLookup, pstl_par_unseq, pstl::execution::par_unseq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_FlatMapLookup, threads_par, threaded::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_StdMapLookup, std_seq, std::execution::seq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_StdMapLookup, std_par, std::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_StdMapLookup, std_par_unseq, std::execution::par_unseq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_StdMapLookup, pstl_seq, pstl::execution::seq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_StdMapLookup, pstl_unseq, pstl::execution::unseq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_StdMapLookup, pstl_par, pstl::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_StdMapLookup, pstl_par_unseq, pstl::execution::par_unseq)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_StdMapLookup, threads_par, threaded::execution::par)->RangeMultiplier(8)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,129 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "AlgorithmDispatch.h"
+
+// Read-mostly sorted vector containers, built in bulk with sort + unique under any
+// policy and searched without branches: the loop below always runs log2(n) steps and
+// compiles to a conditional move, so there is no misprediction per level. Batched
+// lookups are a transform over the queries with the same policy interface as algo::.
+//
+//	auto index = FlatSet<std::uint32_t>::Build(std::execution::par, keys);
+//	index.Contains(std::execution::par, queries.begin(), queries.end(), found.begin());
+
+// Index of the first element of the sorted [first, first + n) not less than key.
+template <typename Key, typename Compare>
+std::size_t BranchlessLowerBound(const Key* first, std::size_t n, const Key& key, Compare comp)
+{
+	if (n == 0)
+		return 0;
+	const Key* base = first;
+	while (n > 1)
+	{
+		const std::size_t half = n / 2;
+		base = comp(base[half], key) ? base + half : base;
+		n -= half;
+	}
+	return static_cast<std::size_t>(base - first) + (comp(*base, key) ? 1 : 0);
+}
+
+template <typename Key, typename Compare = std::less<Key>>
+class FlatSet
+{
+public:
+	FlatSet() = default;
+
+	// sorts and deduplicates keys in place and takes them over
+	template <typename Policy>
+	static FlatSet Build(Policy&& policy, std::vector<Key> keys, Compare comp = Compare())
+	{
+		algo::sort(policy, keys.begin(), keys.end(), comp);
+		keys.erase(algo::unique(policy, keys.begin(), keys.end(), [comp](const Key& a, const Key& b) { return !comp(a, b) && !comp(b, a); }), keys.end());
+		keys.shrink_to_fit();
+		return FlatSet(std::move(keys), comp);
+	}
+
+	std::size_t Size() const { return keys_.size(); }
+	std::size_t MemoryBytes() const { return keys_.capacity() * sizeof(Key); }
+	const std::vector<Key>& Keys() const { return keys_; }
+
+	std::size_t LowerBound(const Key& key) const
+	{
+		return BranchlessLowerBound(keys_.data(), keys_.size(), key, comp_);
+	}
+
+	bool Contains(const Key& key) const
+	{
+		const std::size_t i = LowerBound(key);
+		return i < keys_.size() && !comp_(key, keys_[i]);
+	}
+
+	// out[i] = Contains(queries[i]); out must not be a vector<bool> under parallel policies
+	template <typename Policy, typename QueryIt, typename OutputIt>
+	OutputIt Contains(Policy&& policy, QueryIt first, QueryIt last, OutputIt out) const
+	{
+		return algo::transform(std::forward<Policy>(policy), first, last, out, [this](const Key& key) { return Contains(key); });
+	}
+
+private:
+	FlatSet(std::vector<Key> keys, Compare comp) : keys_(std::move(keys)), comp_(comp) {}
+
+	std::vector<Key> keys_;
+	Compare comp_;
+};
+
+// FlatSet with a value per key. Keys and values are kept in separate arrays, so a
+// search only walks the keys.
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class FlatMap
+{
+public:
+	FlatMap() = default;
+
+	// for duplicate keys the first entry wins
+	template <typename Policy>
+	static FlatMap Build(Policy&& policy, std::vector<std::pair<Key, Value>> entries, Compare comp = Compare())
+	{
+		auto byKey = [comp](const std::pair<Key, Value>& a, const std::pair<Key, Value>& b) { return comp(a.first, b.first); };
+		algo::stable_sort(policy, entries.begin(), entries.end(), byKey);
+		entries.erase(algo::unique(policy, entries.begin(), entries.end(),
+			[byKey](const std::pair<Key, Value>& a, const std::pair<Key, Value>& b) { return !byKey(a, b) && !byKey(b, a); }), entries.end());
+
+		FlatMap map;
+		map.comp_ = comp;
+		map.keys_.resize(entries.size());
+		map.values_.resize(entries.size());
+		algo::transform(policy, entries.begin(), entries.end(), map.keys_.begin(), [](const std::pair<Key, Value>& e) { return e.first; });
+		algo::transform(policy, entries.begin(), entries.end(), map.values_.begin(), [](const std::pair<Key, Value>& e) { return e.second; });
+		return map;
+	}
+
+	std::size_t Size() const { return keys_.size(); }
+	std::size_t MemoryBytes() const { return keys_.capacity() * sizeof(Key) + values_.capacity() * sizeof(Value); }
+
+	const Value* Find(const Key& key) const
+	{
+		const std::size_t i = BranchlessLowerBound(keys_.data(), keys_.size(), key, comp_);
+		return i < keys_.size() && !comp_(key, keys_[i]) ? &values_[i] : nullptr;
+	}
+
+	// out[i] = value of queries[i], or missing
+	template <typename Policy, typename QueryIt, typename OutputIt>
+	OutputIt Find(Policy&& policy, QueryIt first, QueryIt last, OutputIt out, const Value& missing) const
+	{
+		return algo::transform(std::forward<Policy>(policy), first, last, out, [this, missing](const Key& key) {
+			const Value* value = Find(key);
+			return value ? *value : missing;
+		});
+	}
+
+private:
+	std::vector<Key> keys_;
+	std::vector<Value> values_;
+	Compare comp_;
+};
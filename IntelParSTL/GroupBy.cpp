@@ -0,0 +1,79 @@
+﻿#include <cstdint>
+#include <execution>
+#include <string>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/execution>
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+#include "GroupBy.h"
+#include "SalesData.h"
+
+// "Sum profit by product" over the sales table: sort based versus hash based group-by
+// (GroupBy.h) for 10 to 10M distinct products. Few groups favour the hash tables
+// (they stay in L1), many groups turn both into a memory bound shuffle.
+//
+// Counter: rows, input rows aggregated per second.
+
+template <typename Policy>
+static void BM_GroupBySort(benchmark::State& state, std::uint32_t products, Policy execution_policy)
+{
+	const auto ids = GenProductIds(state.range(0), products);
+	const auto profit = GenProfit(ids.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		auto groups = groupby::SortSum(execution_policy, ids, profit);
+		benchmark::DoNotOptimize(groups.data());
+	}
+	state.counters["rows"] = benchmark::Counter(static_cast<double>(ids.size()), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template <typename Policy>
+static void BM_GroupByHash(benchmark::State& state, std::uint32_t products, Policy execution_policy)
+{
+	const auto ids = GenProductIds(state.range(0), products);
+	const auto profit = GenProfit(ids.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		auto groups = groupby::HashSum(execution_policy, ids, profit);
+		benchmark::DoNotOptimize(groups.data());
+	}
+	state.counters["rows"] = benchmark::Counter(static_cast<double>(ids.size()), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// The product count goes into the kernel name: BM_GroupByHash<1000>/pstl_par/1000000.
+template <typename Policy>
+static void RegisterGroupByBenchmarks(std::uint32_t products, const std::string& policyName, Policy policy)
+{
+	const std::string suffix = "<" + std::to_string(products) + ">/" + policyName;
+	benchmark::RegisterBenchmark(("BM_GroupBySort" + suffix).c_str(),
+		[products, policy](benchmark::State& state) { BM_GroupBySort(state, products, policy); })
+		->RangeMultiplier(10)->Range(1000000, 10000000)->Unit(benchmark::kMillisecond);
+	benchmark::RegisterBenchmark(("BM_GroupByHash" + suffix).c_str(),
+		[products, policy](benchmark::State& state) { BM_GroupByHash(state, products, policy); })
+		->RangeMultiplier(10)->Range(1000000, 10000000)->Unit(benchmark::kMillisecond);
+}
+
+// the sort and the hash tables are not vectorisable, so seq and par only
+static void RegisterGroupByBenchmarks(std::uint32_t products)
+{
+	RegisterGroupByBenchmarks(products, "std_seq", std::execution::seq);
+	RegisterGroupByBenchmarks(products, "std_par", std::execution::par);
+	RegisterGroupByBenchmarks(products, "pstl_seq", pstl::execution::seq);
+	RegisterGroupByBenchmarks(products, "pstl_par", pstl::execution::par);
+	RegisterGroupByBenchmarks(products, "threads_par", threaded::execution::par);
+}
+
+static const bool GroupByBenchmarksRegistered = []() {
+	for (std::uint32_t products : { 10u, 1000u, 100000u, 10000000u })
+		RegisterGroupByBenchmarks(products);
+	return true;
+}();
@@ -0,0 +1,116 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <pstl/iterators.h>
+
+#include "AlgorithmDispatch.h"
+#include "BucketPartition.h"
+#include "HashTable.h"
+
+// SELECT key, SUM(value) GROUP BY key over two columns, in two ways:
+//	SortSum  pairs the columns up, sorts by key, then reduces runs of equal keys, one
+//	         chunk per worker with the chunk borders moved to key changes
+//	HashSum  every chunk of rows aggregates into its own OpenHashMap, spills the
+//	         entries into one list per partition (by key hash), and every partition
+//	         merges its lists from all chunks in a fresh table; no locks, no shared table
+// Sort output is ordered by key, hash output is in no particular order.
+namespace groupby
+{
+	template <typename Key>
+	using GroupSum = std::pair<Key, double>;
+
+	template <typename Policy>
+	std::ptrdiff_t WorkChunks(Policy&&, std::ptrdiff_t n)
+	{
+		return algo::IsSequential<Policy> ? 1 : threaded::ChunkCount(n);
+	}
+
+	// Concatenates the per chunk results, each chunk copying its own part.
+	template <typename Policy, typename T>
+	std::vector<T> Concatenate(Policy&& policy, const std::vector<std::vector<T>>& parts)
+	{
+		std::vector<std::size_t> offsets(parts.size() + 1, 0);
+		for (std::size_t p = 0; p < parts.size(); ++p)
+			offsets[p + 1] = offsets[p] + parts[p].size();
+
+		std::vector<T> all(offsets.back());
+		bucket::ForEachChunk(policy, static_cast<std::ptrdiff_t>(parts.size()), [&](std::ptrdiff_t p) {
+			std::copy(parts[p].begin(), parts[p].end(), all.begin() + offsets[p]);
+		});
+		return all;
+	}
+
+	template <typename Policy, typename Key>
+	std::vector<GroupSum<Key>> SortSum(Policy&& policy, const std::vector<Key>& keys, const std::vector<double>& values)
+	{
+		const auto n = static_cast<std::ptrdiff_t>(keys.size());
+		std::vector<GroupSum<Key>> rows(n);
+		algo::transform(policy, pstl::counting_iterator<std::ptrdiff_t>(0), pstl::counting_iterator<std::ptrdiff_t>(n), rows.begin(),
+			[&keys, &values](std::ptrdiff_t i) { return GroupSum<Key>(keys[i], values[i]); });
+
+		auto byKey = [](const GroupSum<Key>& a, const GroupSum<Key>& b) { return a.first < b.first; };
+		algo::sort(policy, rows.begin(), rows.end(), byKey);
+
+		// chunk borders moved forward past the group they fall into, so no group spans two chunks
+		const auto chunks = WorkChunks(policy, n);
+		std::vector<std::ptrdiff_t> chunkBegin(chunks + 1, n);
+		for (std::ptrdiff_t c = 0; c < chunks; ++c)
+		{
+			auto b = n * c / chunks;
+			if (b > 0 && b < n && rows[b].first == rows[b - 1].first)
+				b = std::upper_bound(rows.begin(), rows.end(), rows[b], byKey) - rows.begin();
+			chunkBegin[c] = b;
+		}
+
+		std::vector<std::vector<GroupSum<Key>>> parts(chunks);
+		bucket::ForEachChunk(policy, chunks, [&](std::ptrdiff_t c) {
+			auto& part = parts[c];
+			for (auto i = chunkBegin[c]; i < chunkBegin[c + 1]; ++i)
+			{
+				if (part.empty() || part.back().first != rows[i].first)
+					part.push_back(rows[i]);
+				else
+					part.back().second += rows[i].second;
+			}
+		});
+		return Concatenate(policy, parts);
+	}
+
+	template <typename Policy, typename Key>
+	std::vector<GroupSum<Key>> HashSum(Policy&& policy, const std::vector<Key>& keys, const std::vector<double>& values)
+	{
+		const auto n = static_cast<std::ptrdiff_t>(keys.size());
+		const auto chunks = WorkChunks(policy, n);
+		auto partitionOf = [chunks](Key key) { return static_cast<std::ptrdiff_t>((HashKey(key) >> 40) % chunks); };
+
+		// spills[chunk][partition]
+		std::vector<std::vector<std::vector<GroupSum<Key>>>> spills(chunks, std::vector<std::vector<GroupSum<Key>>>(chunks));
+		bucket::ForEachChunk(policy, chunks, [&](std::ptrdiff_t c) {
+			OpenHashMap<Key, double> table;
+			for (auto i = n * c / chunks; i < n * (c + 1) / chunks; ++i)
+				table[keys[i]] += values[i];
+			table.ForEach([&](Key key, double sum) { spills[c][partitionOf(key)].emplace_back(key, sum); });
+		});
+
+		std::vector<std::vector<GroupSum<Key>>> parts(chunks);
+		bucket::ForEachChunk(policy, chunks, [&](std::ptrdiff_t p) {
+			std::size_t expected = 0;
+			for (const auto& spill : spills)
+				expected += spill[p].size();
+
+			OpenHashMap<Key, double> table(expected);
+			for (const auto& spill : spills)
+			{
+				for (const auto& entry : spill[p])
+					table[entry.first] += entry.second;
+			}
+			parts[p].reserve(table.Size());
+			table.ForEach([&](Key key, double sum) { parts[p].emplace_back(key, sum); });
+		});
+		return Concatenate(policy, parts);
+	}
+}
@@ -0,0 +1,104 @@
+﻿#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/execution>
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+#include "HashJoin.h"
+#include "SalesData.h"
+
+// Sales joined with the product table (HashJoin.h) for 1K to 10M products, against a
+// fixed 10M sales. 1K products (16 KB of columns, 16 KB of hash table) sit in L1/L2,
+// 100K (1.6 MB / 2 MB) spill out of L2 and 10M out of any LLC, which is where the
+// partitioned join should pull ahead of the shared table.
+//
+// Counter: tuples, build plus probe rows per second.
+
+constexpr std::size_t JoinSales = 10000000;
+
+static join::Sales GenJoinSales(std::uint32_t products)
+{
+	join::Sales sales;
+	sales.productIds = GenProductIds(JoinSales, products);
+	sales.quantities.resize(JoinSales);
+	std::generate(sales.quantities.begin(), sales.quantities.end(), []() { return static_cast<std::uint32_t>(GenRandomInt(1, 100)); });
+	return sales;
+}
+
+static void SetJoinCounters(benchmark::State& state, const ProductTable& products, const join::Sales& sales)
+{
+	state.counters["tuples"] = benchmark::Counter(static_cast<double>(products.ids.size() + sales.productIds.size()), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template <typename Policy>
+static void BM_JoinSharedTable(benchmark::State& state, Policy execution_policy)
+{
+	const auto products = GenProductTable(static_cast<std::uint32_t>(state.range(0)));
+	const auto sales = GenJoinSales(static_cast<std::uint32_t>(state.range(0)));
+	std::vector<join::JoinedSale> joined(sales.productIds.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		join::SharedTable(execution_policy, products, sales, joined);
+		benchmark::ClobberMemory();
+	}
+	SetJoinCounters(state, products, sales);
+}
+
+template <typename Policy>
+static void BM_JoinRadixPartitioned(benchmark::State& state, Policy execution_policy)
+{
+	const auto products = GenProductTable(static_cast<std::uint32_t>(state.range(0)));
+	const auto sales = GenJoinSales(static_cast<std::uint32_t>(state.range(0)));
+	std::vector<join::JoinedSale> joined(sales.productIds.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		join::RadixPartitioned(execution_policy, products, sales, joined);
+		benchmark::ClobberMemory();
+	}
+	SetJoinCounters(state, products, sales);
+}
+
+template <typename Policy>
+static void BM_JoinSortMerge(benchmark::State& state, Policy execution_policy)
+{
+	const auto products = GenProductTable(static_cast<std::uint32_t>(state.range(0)));
+	const auto sales = GenJoinSales(static_cast<std::uint32_t>(state.range(0)));
+	std::vector<join::JoinedSale> joined(sales.productIds.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		join::SortMerge(execution_policy, products, sales, joined);
+		benchmark::ClobberMemory();
+	}
+	SetJoinCounters(state, products, sales);
+}
+
+// CAS inserts and the partition scatter are not vectorisable, so seq and par only
+BENCHMARK_CAPTURE(BM_JoinSharedTable, std_seq, std::execution::seq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_JoinSharedTable, std_par, std::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_JoinSharedTable, pstl_seq, pstl::execution::seq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_JoinSharedTable, pstl_par, pstl::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_JoinSharedTable, threads_par, threaded::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_JoinRadixPartitioned, std_seq, std::execution::seq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_JoinRadixPartitioned, std_par, std::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_JoinRadixPartitioned, pstl_seq, pstl::execution::seq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_JoinRadixPartitioned, pstl_par, pstl::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_JoinRadixPartitioned, threads_par, threaded::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_JoinSortMerge, std_seq, std::execution::seq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_JoinSortMerge, std_par, std::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_JoinSortMerge, pstl_seq, pstl::execution::seq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_JoinSortMerge, pstl_par, pstl::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_JoinSortMerge, threads_par, threaded::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMillisecond);
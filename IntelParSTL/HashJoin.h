@@ -0,0 +1,169 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <pstl/iterators.h>
+
+#include "AlgorithmDispatch.h"
+#include "BucketPartition.h"
+#include "HashTable.h"
+#include "RadixSort.h"
+#include "SalesData.h"
+
+// SELECT p.price, s.quantity, p.category FROM sales s JOIN products p ON s.product = p.id
+// with unique product ids, three ways:
+//	SharedTable       one ConcurrentHashMap id -> product row for all workers, built by
+//	                  for_each with CAS inserts, then probed by for_each over the sales
+//	RadixPartitioned  both sides are partitioned by the high hash bits (bucket::Partition)
+//	                  into partitions whose build side stays in L2, then every partition
+//	                  builds and probes a private OpenHashMap
+//	SortMerge         both sides are radix sorted as (id, row) pairs, then merged, one
+//	                  chunk of the sorted sales per worker
+// The output has one row per sale, at the sale's position; sales without a product
+// are left untouched.
+namespace join
+{
+	using Row = std::uint32_t;
+
+	struct JoinedSale
+	{
+		double price;
+		std::uint32_t quantity;
+		std::uint32_t category;
+	};
+
+	struct Sales
+	{
+		std::vector<std::uint32_t> productIds;
+		std::vector<std::uint32_t> quantities;
+	};
+
+	template <typename Policy>
+	void SharedTable(Policy&& policy, const ProductTable& products, const Sales& sales, std::vector<JoinedSale>& out)
+	{
+		const auto buildRows = static_cast<Row>(products.ids.size());
+		const auto probeRows = static_cast<Row>(sales.productIds.size());
+
+		ConcurrentHashMap<std::uint32_t, Row> table(policy, buildRows);
+		algo::for_each(policy, pstl::counting_iterator<Row>(0), pstl::counting_iterator<Row>(buildRows),
+			[&table, &products](Row row) { table.Insert(products.ids[row], row); });
+
+		algo::for_each(policy, pstl::counting_iterator<Row>(0), pstl::counting_iterator<Row>(probeRows),
+			[&table, &products, &sales, &out](Row sale) {
+			if (const Row* row = table.Find(sales.productIds[sale]))
+				out[sale] = { products.prices[*row], sales.quantities[sale], products.categories[*row] };
+		});
+	}
+
+	// build side rows per partition, 16K keys and rows take 256 KB of hash table
+	constexpr std::size_t PartitionBuildRows = 16384;
+	constexpr int MaxPartitionBits = 12;
+
+	inline int PartitionBits(std::size_t buildRows)
+	{
+		int bits = 0;
+		while ((buildRows >> bits) > PartitionBuildRows && bits < MaxPartitionBits)
+			++bits;
+		return bits;
+	}
+
+	// (key, row) of one side of the join
+	using Tuple = std::pair<std::uint32_t, Row>;
+
+	template <typename Policy>
+	std::vector<Tuple> MakeTuples(Policy&& policy, const std::vector<std::uint32_t>& keys)
+	{
+		std::vector<Tuple> tuples(keys.size());
+		algo::transform(policy, pstl::counting_iterator<Row>(0), pstl::counting_iterator<Row>(static_cast<Row>(keys.size())),
+			tuples.begin(), [&keys](Row row) { return Tuple(keys[row], row); });
+		return tuples;
+	}
+
+	template <typename Policy>
+	void RadixPartitioned(Policy&& policy, const ProductTable& products, const Sales& sales, std::vector<JoinedSale>& out)
+	{
+		const int bits = PartitionBits(products.ids.size());
+		const std::size_t partitions = std::size_t(1) << bits;
+		auto partitionOf = [bits](const Tuple& tuple) {
+			return bits == 0 ? std::size_t(0) : static_cast<std::size_t>(HashKey(tuple.first) >> (64 - bits));
+		};
+
+		const auto buildTuples = MakeTuples(policy, products.ids);
+		const auto probeTuples = MakeTuples(policy, sales.productIds);
+		std::vector<Tuple> build(buildTuples.size()), probe(probeTuples.size());
+		const auto buildBegin = bucket::Partition(policy, buildTuples.begin(), buildTuples.end(), build.begin(), partitions, partitionOf);
+		const auto probeBegin = bucket::Partition(policy, probeTuples.begin(), probeTuples.end(), probe.begin(), partitions, partitionOf);
+
+		// one chunk per partition, except for the plain threads, which get a range of them each
+		const auto chunks = static_cast<std::ptrdiff_t>(algo::IsThreaded<Policy> ? std::min<std::size_t>(threaded::WorkerCount(), partitions) : partitions);
+		bucket::ForEachChunk(policy, chunks, [&](std::ptrdiff_t c) {
+			for (std::size_t p = partitions * c / chunks; p < partitions * (c + 1) / chunks; ++p)
+			{
+				OpenHashMap<std::uint32_t, Row> table(buildBegin[p + 1] - buildBegin[p]);
+				for (auto i = buildBegin[p]; i < buildBegin[p + 1]; ++i)
+					table[build[i].first] = build[i].second;
+
+				for (auto i = probeBegin[p]; i < probeBegin[p + 1]; ++i)
+				{
+					const Row sale = probe[i].second;
+					if (const Row* row = table.Find(probe[i].first))
+						out[sale] = { products.prices[*row], sales.quantities[sale], products.categories[*row] };
+				}
+			}
+		});
+	}
+
+	// key in the high half, so sorting the packed values sorts by key
+	inline std::uint64_t PackKeyRow(std::uint32_t key, Row row)
+	{
+		return (static_cast<std::uint64_t>(key) << 32) | row;
+	}
+
+	template <typename Policy>
+	std::vector<std::uint64_t> SortedKeyRows(Policy&& policy, const std::vector<std::uint32_t>& keys)
+	{
+		std::vector<std::uint64_t> keyRows(keys.size());
+		algo::transform(policy, pstl::counting_iterator<Row>(0), pstl::counting_iterator<Row>(static_cast<Row>(keys.size())),
+			keyRows.begin(), [&keys](Row row) { return PackKeyRow(keys[row], row); });
+		radix::sort(policy, keyRows.begin(), keyRows.end());
+		return keyRows;
+	}
+
+	template <typename Policy>
+	void SortMerge(Policy&& policy, const ProductTable& products, const Sales& sales, std::vector<JoinedSale>& out)
+	{
+		const auto build = SortedKeyRows(policy, products.ids);
+		const auto probe = SortedKeyRows(policy, sales.productIds);
+		const auto keyOf = [](std::uint64_t keyRow) { return static_cast<std::uint32_t>(keyRow >> 32); };
+		const auto rowOf = [](std::uint64_t keyRow) { return static_cast<Row>(keyRow); };
+
+		const auto n = static_cast<std::ptrdiff_t>(probe.size());
+		const auto chunks = algo::IsSequential<Policy> ? 1 : threaded::ChunkCount(n);
+		bucket::ForEachChunk(policy, chunks, [&](std::ptrdiff_t c) {
+			const auto begin = n * c / chunks;
+			const auto end = n * (c + 1) / chunks;
+			if (begin == end)
+				return;
+
+			auto product = std::lower_bound(build.begin(), build.end(), PackKeyRow(keyOf(probe[begin]), 0));
+			for (auto i = begin; i < end; ++i)
+			{
+				const auto key = keyOf(probe[i]);
+				while (product != build.end() && keyOf(*product) < key)
+					++product;
+				if (product == build.end())
+					break;
+				if (keyOf(*product) == key)
+				{
+					const Row row = rowOf(*product);
+					const Row sale = rowOf(probe[i]);
+					out[sale] = { products.prices[row], sales.quantities[sale], products.categories[row] };
+				}
+			}
+		});
+	}
+}
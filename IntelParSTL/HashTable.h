@@ -0,0 +1,196 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <pstl/iterators.h>
+
+#include "AlgorithmDispatch.h"
+
+// 64-bit mix (MurmurHash3 finaliser); all output bits depend on all key bits, so the
+// low bits can pick a slot and the high bits a partition.
+inline std::uint64_t HashKey(std::uint64_t key)
+{
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdull;
+	key ^= key >> 33;
+	key *= 0xc4ceb9fe1a85ec53ull;
+	key ^= key >> 33;
+	return key;
+}
+
+// Single threaded open addressing map from integer keys to values: linear probing,
+// power of two capacity, at most half full. Keys and values live in two flat arrays,
+// and the largest key value marks empty slots, so it can't be used as a key.
+template <typename Key, typename Value>
+class OpenHashMap
+{
+	static_assert(std::is_integral<Key>::value, "integer keys only");
+
+public:
+	static constexpr Key EmptyKey = std::numeric_limits<Key>::max();
+
+	explicit OpenHashMap(std::size_t expectedSize = 8)
+	{
+		Reserve(expectedSize);
+	}
+
+	std::size_t Size() const { return size_; }
+
+	void Reserve(std::size_t expectedSize)
+	{
+		std::size_t capacity = 16;
+		while (capacity < 2 * expectedSize)
+			capacity *= 2;
+		if (capacity > keys_.size())
+			Rehash(capacity);
+	}
+
+	// value-initialised on first access
+	Value& operator[](Key key)
+	{
+		if (2 * (size_ + 1) > keys_.size())
+			Rehash(2 * keys_.size());
+
+		std::size_t slot = HashKey(key) & mask_;
+		while (keys_[slot] != key)
+		{
+			if (keys_[slot] == EmptyKey)
+			{
+				keys_[slot] = key;
+				++size_;
+				break;
+			}
+			slot = (slot + 1) & mask_;
+		}
+		return values_[slot];
+	}
+
+	const Value* Find(Key key) const
+	{
+		for (std::size_t slot = HashKey(key) & mask_; keys_[slot] != EmptyKey; slot = (slot + 1) & mask_)
+		{
+			if (keys_[slot] == key)
+				return &values_[slot];
+		}
+		return nullptr;
+	}
+
+	// f(key, value) for every entry, in slot order
+	template <typename Function>
+	void ForEach(Function f) const
+	{
+		for (std::size_t slot = 0; slot < keys_.size(); ++slot)
+		{
+			if (keys_[slot] != EmptyKey)
+				f(keys_[slot], values_[slot]);
+		}
+	}
+
+private:
+	void Rehash(std::size_t capacity)
+	{
+		std::vector<Key> oldKeys(capacity, EmptyKey);
+		std::vector<Value> oldValues(capacity);
+		oldKeys.swap(keys_);
+		oldValues.swap(values_);
+		mask_ = capacity - 1;
+		size_ = 0;
+
+		for (std::size_t slot = 0; slot < oldKeys.size(); ++slot)
+		{
+			if (oldKeys[slot] != EmptyKey)
+				(*this)[oldKeys[slot]] = std::move(oldValues[slot]);
+		}
+	}
+
+	std::vector<Key> keys_;
+	std::vector<Value> values_;
+	std::size_t mask_ = 0;
+	std::size_t size_ = 0;
+};
+
+// Fixed capacity open addressing map that many threads can fill at once, e.g. from
+// for_each(par): linear probing like OpenHashMap, a slot is claimed by a compare and
+// swap of its key from EmptyKey, no locks. The capacity is set up front from the
+// expected size and a maximum load factor (half full by default) and never grows: more
+// keys than that only raise the load, and once every slot is taken Insert gives up
+// after one round of the table and reports Full. Values are plain stores, so Find is
+// only meant for after the inserting algorithm has returned (the join of its workers
+// publishes them).
+template <typename Key, typename Value>
+class ConcurrentHashMap
+{
+	static_assert(std::is_integral<Key>::value, "integer keys only");
+
+public:
+	static constexpr Key EmptyKey = std::numeric_limits<Key>::max();
+
+	enum class InsertResult
+	{
+		Inserted,
+		Present, // the key was already there, its value is left alone
+		Full     // probed every slot without finding the key or a free one
+	};
+
+	// the slots are cleared with the policy, a big table is a memory bound pass of its own
+	template <typename Policy>
+	ConcurrentHashMap(Policy&& policy, std::size_t expectedSize, double maxLoadFactor = 0.5)
+	{
+		std::size_t capacity = 16;
+		while (capacity * maxLoadFactor < expectedSize)
+			capacity *= 2;
+		mask_ = capacity - 1;
+		keys_.reset(new std::atomic<Key>[capacity]);
+		values_.reset(new Value[capacity]);
+
+		std::atomic<Key>* keys = keys_.get();
+		algo::for_each(std::forward<Policy>(policy), pstl::counting_iterator<std::size_t>(0), pstl::counting_iterator<std::size_t>(capacity),
+			[keys](std::size_t slot) { keys[slot].store(EmptyKey, std::memory_order_relaxed); });
+	}
+
+	std::size_t Capacity() const { return mask_ + 1; }
+
+	InsertResult Insert(Key key, const Value& value)
+	{
+		std::size_t slot = HashKey(key) & mask_;
+		for (std::size_t probe = 0; probe < Capacity(); ++probe, slot = (slot + 1) & mask_)
+		{
+			Key current = keys_[slot].load(std::memory_order_relaxed);
+			if (current == EmptyKey && keys_[slot].compare_exchange_strong(current, key, std::memory_order_relaxed))
+			{
+				values_[slot] = value;
+				return InsertResult::Inserted;
+			}
+			// current is the key holding the slot now, possibly the same key from a racing insert
+			if (current == key)
+				return InsertResult::Present;
+		}
+		return InsertResult::Full;
+	}
+
+	const Value* Find(Key key) const
+	{
+		std::size_t slot = HashKey(key) & mask_;
+		for (std::size_t probe = 0; probe < Capacity(); ++probe, slot = (slot + 1) & mask_)
+		{
+			const Key current = keys_[slot].load(std::memory_order_relaxed);
+			if (current == key)
+				return &values_[slot];
+			if (current == EmptyKey)
+				return nullptr;
+		}
+		return nullptr;
+	}
+
+private:
+	std::unique_ptr<std::atomic<Key>[]> keys_;
+	std::unique_ptr<Value[]> values_;
+	std::size_t mask_ = 0;
+};
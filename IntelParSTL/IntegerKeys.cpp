@@ -0,0 +1,141 @@
+﻿#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/numeric>
+#include <pstl/execution>
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+#include "AlgorithmDispatch.h"
+#include "RadixSort.h"
+#include "RandomGen.h"
+
+// Sort, reduce and scan over integer keys: uint32/uint64 ids and int8/int16 codes.
+// Comparison sorts on integers behave differently from the float comparator of
+// BM_SortPoints, and integer keys also allow a radix sort, which is the extra column.
+//
+// Sort inputs are restored from a random copy every iteration, otherwise all but the
+// first iteration would sort sorted data; the copy is included in every sort column.
+// Reduce and scan widen to 64 bits so the narrow codes do not overflow.
+
+template <typename Key>
+using WideSum = std::conditional_t<std::is_signed_v<Key>, std::int64_t, std::uint64_t>;
+
+template <typename Key>
+static std::vector<Key> GenRandomKeys(std::size_t count)
+{
+	std::vector<Key> keys(count);
+	std::generate(keys.begin(), keys.end(), []() { return GenRandomKey<Key>(); });
+	return keys;
+}
+
+template <typename Key, typename Policy>
+static void BM_SortKeys(benchmark::State& state, Policy execution_policy)
+{
+	const auto input = GenRandomKeys<Key>(state.range(0));
+	std::vector<Key> keys(input.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::copy(input.begin(), input.end(), keys.begin());
+		algo::sort(execution_policy, keys.begin(), keys.end());
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(state.iterations() * input.size() * sizeof(Key));
+}
+
+template <typename Key, typename Policy>
+static void BM_RadixSortKeys(benchmark::State& state, Policy execution_policy)
+{
+	const auto input = GenRandomKeys<Key>(state.range(0));
+	std::vector<Key> keys(input.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::copy(input.begin(), input.end(), keys.begin());
+		radix::sort(execution_policy, keys.begin(), keys.end());
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(state.iterations() * input.size() * sizeof(Key));
+}
+
+template <typename Key, typename Policy>
+static void BM_ReduceKeys(benchmark::State& state, Policy execution_policy)
+{
+	const auto keys = GenRandomKeys<Key>(state.range(0));
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		WideSum<Key> sum = algo::transform_reduce(execution_policy, keys.begin(), keys.end(), WideSum<Key>(0),
+			std::plus<WideSum<Key>>(), [](Key k) { return static_cast<WideSum<Key>>(k); });
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetBytesProcessed(state.iterations() * keys.size() * sizeof(Key));
+}
+
+template <typename Key, typename Policy>
+static void BM_ScanKeys(benchmark::State& state, Policy execution_policy)
+{
+	const auto keys = GenRandomKeys<Key>(state.range(0));
+	std::vector<WideSum<Key>> sums(keys.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		algo::transform_inclusive_scan(execution_policy, keys.begin(), keys.end(), sums.begin(),
+			std::plus<WideSum<Key>>(), [](Key k) { return static_cast<WideSum<Key>>(k); });
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(state.iterations() * keys.size() * sizeof(Key));
+}
+
+// BENCHMARK_CAPTURE can't take a template-id (the name is token-pasted), so the key
+// type goes into the benchmark name here: BM_SortKeys<uint32>/pstl_par/1000.
+template <typename Key, typename Policy>
+static void RegisterIntegerKeyBenchmarks(const std::string& keyName, const std::string& policyName, Policy policy)
+{
+	const std::string suffix = "<" + keyName + ">/" + policyName;
+	benchmark::RegisterBenchmark(("BM_SortKeys" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_SortKeys<Key>(state, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_RadixSortKeys" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_RadixSortKeys<Key>(state, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_ReduceKeys" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_ReduceKeys<Key>(state, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_ScanKeys" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_ScanKeys<Key>(state, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+}
+
+template <typename Key>
+static void RegisterIntegerKeyBenchmarks(const std::string& keyName)
+{
+	RegisterIntegerKeyBenchmarks<Key>(keyName, "std_seq", std::execution::seq);
+	RegisterIntegerKeyBenchmarks<Key>(keyName, "std_par", std::execution::par);
+	RegisterIntegerKeyBenchmarks<Key>(keyName, "std_par_unseq", std::execution::par_unseq);
+	RegisterIntegerKeyBenchmarks<Key>(keyName, "pstl_seq", pstl::execution::seq);
+	RegisterIntegerKeyBenchmarks<Key>(keyName, "pstl_unseq", pstl::execution::unseq);
+	RegisterIntegerKeyBenchmarks<Key>(keyName, "pstl_par", pstl::execution::par);
+	RegisterIntegerKeyBenchmarks<Key>(keyName, "pstl_par_unseq", pstl::execution::par_unseq);
+	RegisterIntegerKeyBenchmarks<Key>(keyName, "threads_par", threaded::execution::par);
+}
+
+static const bool IntegerKeyBenchmarksRegistered = []() {
+	RegisterIntegerKeyBenchmarks<std::int8_t>("int8");
+	RegisterIntegerKeyBenchmarks<std::int16_t>("int16");
+	RegisterIntegerKeyBenchmarks<std::uint32_t>("uint32");
+	RegisterIntegerKeyBenchmarks<std::uint64_t>("uint64");
+	return true;
+}();
@@ -0,0 +1,260 @@
+﻿#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <execution>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/execution>
+#include <pstl/memory>
+
+#include "glm/vec4.hpp" // glm::vec4
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+// Pure data movement under every std / pstl policy, for bytes, doubles and glm::vec4,
+// from 4 KiB (L1) to 1 GiB (DRAM). The size argument is the buffer size in bytes, and
+// bytes_per_second counts every byte read plus every byte written, so the numbers line
+// up with the single threaded BM_Memcpy / BM_Memset baselines.
+//
+// All buffers are touched before timing, except in BM_FillFirstTouch which fills
+// freshly allocated memory, so page faults are part of the measurement there.
+// These algorithms have no threaded:: implementation, hence no threads_par column.
+
+template <typename T>
+static std::vector<T> MakeBuffer(benchmark::State& state)
+{
+	return std::vector<T>(static_cast<std::size_t>(state.range(0)) / sizeof(T), T(1));
+}
+
+template <typename T>
+static void SetTraffic(benchmark::State& state, std::size_t elements, int bytesPerElementMultiple)
+{
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(elements * sizeof(T) * bytesPerElementMultiple));
+}
+
+static void BM_Memset(benchmark::State& state)
+{
+	std::vector<std::uint8_t> data(state.range(0), 1);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::memset(data.data(), 0, data.size());
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_Memcpy(benchmark::State& state)
+{
+	std::vector<std::uint8_t> src(state.range(0), 1), dst(state.range(0), 0);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::memcpy(dst.data(), src.data(), src.size());
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(state.iterations() * 2 * state.range(0));
+}
+
+BENCHMARK(BM_Memset)->RangeMultiplier(8)->Range(1 << 12, 1 << 30)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Memcpy)->RangeMultiplier(8)->Range(1 << 12, 1 << 30)->Unit(benchmark::kMicrosecond);
+
+template <typename T, typename Policy>
+static void BM_Fill(benchmark::State& state, Policy execution_policy)
+{
+	auto data = MakeBuffer<T>(state);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::fill(execution_policy, data.begin(), data.end(), T(0));
+		benchmark::ClobberMemory();
+	}
+	SetTraffic<T>(state, data.size(), 1);
+}
+
+template <typename T, typename Policy>
+static void BM_FillN(benchmark::State& state, Policy execution_policy)
+{
+	auto data = MakeBuffer<T>(state);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::fill_n(execution_policy, data.begin(), data.size(), T(0));
+		benchmark::ClobberMemory();
+	}
+	SetTraffic<T>(state, data.size(), 1);
+}
+
+template <typename T, typename Policy>
+static void BM_FillFirstTouch(benchmark::State& state, Policy execution_policy)
+{
+	const auto count = static_cast<std::size_t>(state.range(0)) / sizeof(T);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		// default-initialised, so the pages are first touched by the fill
+		std::unique_ptr<T[]> data(new T[count]);
+		std::fill(execution_policy, data.get(), data.get() + count, T(0));
+		benchmark::ClobberMemory();
+	}
+	SetTraffic<T>(state, count, 1);
+}
+
+template <typename T, typename Policy>
+static void BM_Generate(benchmark::State& state, Policy execution_policy)
+{
+	auto data = MakeBuffer<T>(state);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::generate(execution_policy, data.begin(), data.end(), []() { return T(2); });
+		benchmark::ClobberMemory();
+	}
+	SetTraffic<T>(state, data.size(), 1);
+}
+
+template <typename T, typename Policy>
+static void BM_Copy(benchmark::State& state, Policy execution_policy)
+{
+	const auto src = MakeBuffer<T>(state);
+	auto dst = MakeBuffer<T>(state);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::copy(execution_policy, src.begin(), src.end(), dst.begin());
+		benchmark::ClobberMemory();
+	}
+	SetTraffic<T>(state, src.size(), 2);
+}
+
+template <typename T, typename Policy>
+static void BM_CopyN(benchmark::State& state, Policy execution_policy)
+{
+	const auto src = MakeBuffer<T>(state);
+	auto dst = MakeBuffer<T>(state);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::copy_n(execution_policy, src.begin(), src.size(), dst.begin());
+		benchmark::ClobberMemory();
+	}
+	SetTraffic<T>(state, src.size(), 2);
+}
+
+template <typename T, typename Policy>
+static void BM_Move(benchmark::State& state, Policy execution_policy)
+{
+	auto src = MakeBuffer<T>(state);
+	auto dst = MakeBuffer<T>(state);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::move(execution_policy, src.begin(), src.end(), dst.begin());
+		benchmark::ClobberMemory();
+	}
+	SetTraffic<T>(state, src.size(), 2);
+}
+
+template <typename T, typename Policy>
+static void BM_Reverse(benchmark::State& state, Policy execution_policy)
+{
+	auto data = MakeBuffer<T>(state);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::reverse(execution_policy, data.begin(), data.end());
+		benchmark::ClobberMemory();
+	}
+	SetTraffic<T>(state, data.size(), 2);
+}
+
+template <typename T, typename Policy>
+static void BM_Rotate(benchmark::State& state, Policy execution_policy)
+{
+	auto data = MakeBuffer<T>(state);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		// an odd shift, so the halves are not simply swapped
+		std::rotate(execution_policy, data.begin(), data.begin() + data.size() / 3, data.end());
+		benchmark::ClobberMemory();
+	}
+	SetTraffic<T>(state, data.size(), 2);
+}
+
+template <typename T, typename Policy>
+static void BM_SwapRanges(benchmark::State& state, Policy execution_policy)
+{
+	auto first = MakeBuffer<T>(state);
+	auto second = MakeBuffer<T>(state);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::swap_ranges(execution_policy, first.begin(), first.end(), second.begin());
+		benchmark::ClobberMemory();
+	}
+	SetTraffic<T>(state, first.size(), 4);
+}
+
+// The element type goes into the kernel name: BM_Copy<vec4>/pstl_par/1048576.
+template <typename T, typename Policy>
+static void RegisterMemoryBoundBenchmarks(const std::string& typeName, const std::string& policyName, Policy policy)
+{
+	const std::string suffix = "<" + typeName + ">/" + policyName;
+	benchmark::RegisterBenchmark(("BM_Fill" + suffix).c_str(), [policy](benchmark::State& state) { BM_Fill<T>(state, policy); })
+		->RangeMultiplier(8)->Range(1 << 12, 1 << 30)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_FillN" + suffix).c_str(), [policy](benchmark::State& state) { BM_FillN<T>(state, policy); })
+		->RangeMultiplier(8)->Range(1 << 12, 1 << 30)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_FillFirstTouch" + suffix).c_str(), [policy](benchmark::State& state) { BM_FillFirstTouch<T>(state, policy); })
+		->RangeMultiplier(8)->Range(1 << 12, 1 << 30)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_Generate" + suffix).c_str(), [policy](benchmark::State& state) { BM_Generate<T>(state, policy); })
+		->RangeMultiplier(8)->Range(1 << 12, 1 << 30)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_Copy" + suffix).c_str(), [policy](benchmark::State& state) { BM_Copy<T>(state, policy); })
+		->RangeMultiplier(8)->Range(1 << 12, 1 << 30)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_CopyN" + suffix).c_str(), [policy](benchmark::State& state) { BM_CopyN<T>(state, policy); })
+		->RangeMultiplier(8)->Range(1 << 12, 1 << 30)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_Move" + suffix).c_str(), [policy](benchmark::State& state) { BM_Move<T>(state, policy); })
+		->RangeMultiplier(8)->Range(1 << 12, 1 << 30)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_Reverse" + suffix).c_str(), [policy](benchmark::State& state) { BM_Reverse<T>(state, policy); })
+		->RangeMultiplier(8)->Range(1 << 12, 1 << 30)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_Rotate" + suffix).c_str(), [policy](benchmark::State& state) { BM_Rotate<T>(state, policy); })
+		->RangeMultiplier(8)->Range(1 << 12, 1 << 30)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_SwapRanges" + suffix).c_str(), [policy](benchmark::State& state) { BM_SwapRanges<T>(state, policy); })
+		->RangeMultiplier(8)->Range(1 << 12, 1 << 30)->Unit(benchmark::kMicrosecond);
+}
+
+template <typename T>
+static void RegisterMemoryBoundBenchmarks(const std::string& typeName)
+{
+	RegisterMemoryBoundBenchmarks<T>(typeName, "std_seq", std::execution::seq);
+	RegisterMemoryBoundBenchmarks<T>(typeName, "std_par", std::execution::par);
+	RegisterMemoryBoundBenchmarks<T>(typeName, "std_par_unseq", std::execution::par_unseq);
+	RegisterMemoryBoundBenchmarks<T>(typeName, "pstl_seq", pstl::execution::seq);
+	RegisterMemoryBoundBenchmarks<T>(typeName, "pstl_unseq", pstl::execution::unseq);
+	RegisterMemoryBoundBenchmarks<T>(typeName, "pstl_par", pstl::execution::par);
+	RegisterMemoryBoundBenchmarks<T>(typeName, "pstl_par_unseq", pstl::execution::par_unseq);
+}
+
+static const bool MemoryBoundBenchmarksRegistered = []() {
+	RegisterMemoryBoundBenchmarks<std::uint8_t>("byte");
+	RegisterMemoryBoundBenchmarks<double>("double");
+	RegisterMemoryBoundBenchmarks<glm::vec4>("vec4");
+	return true;
+}();
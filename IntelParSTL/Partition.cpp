@@ -0,0 +1,72 @@
+﻿#include <algorithm>
+#include <cstddef>
+#include <execution>
+#include <string>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/execution>
+
+#include "glm/vec4.hpp" // glm::vec4
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+#include "AlgorithmDispatch.h"
+#include "BucketPartition.h"
+#include "RandomGen.h"
+
+// bucket::Partition on the BM_SortPoints data: random points bucketed by .x quantised
+// into B equal slices of [-1, 1], which is one pass of a grid build. B = 2 is a
+// stable_partition, B = 4096 has far more buckets than an L1 line per bucket can hold.
+// Compare with BM_SortPoints for the cost of a full order versus a bucketing.
+
+template <typename Policy>
+static void BM_PartitionPoints(benchmark::State& state, std::size_t buckets, Policy execution_policy)
+{
+	std::vector<glm::vec4> points(state.range(0), { 0.0f, 1.0f, 0.0f, 1.0f });
+	std::generate(points.begin(), points.end(), []() {
+		return glm::vec4(GenRandomFloat(-1.0f, 1.0f), GenRandomFloat(-1.0f, 1.0f), GenRandomFloat(-1.0f, 1.0f), 1.0f);
+	});
+	std::vector<glm::vec4> out(points.size());
+
+	const float scale = buckets / 2.0f;
+	auto bucketOf = [scale, buckets](const glm::vec4& p) {
+		return std::min(static_cast<std::size_t>((p.x + 1.0f) * scale), buckets - 1);
+	};
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		auto bucketBegin = bucket::Partition(execution_policy, points.begin(), points.end(), out.begin(), buckets, bucketOf);
+		benchmark::DoNotOptimize(bucketBegin.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+// The bucket count goes into the kernel name: BM_PartitionPoints<256>/pstl_par/1000.
+template <typename Policy>
+static void RegisterPartitionBenchmark(std::size_t buckets, const std::string& policyName, Policy policy)
+{
+	benchmark::RegisterBenchmark(("BM_PartitionPoints<" + std::to_string(buckets) + ">/" + policyName).c_str(),
+		[buckets, policy](benchmark::State& state) { BM_PartitionPoints(state, buckets, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+}
+
+// like sort, seq and par only: the chunks are not vectorisable
+static void RegisterPartitionBenchmarks(std::size_t buckets)
+{
+	RegisterPartitionBenchmark(buckets, "std_seq", std::execution::seq);
+	RegisterPartitionBenchmark(buckets, "std_par", std::execution::par);
+	RegisterPartitionBenchmark(buckets, "pstl_seq", pstl::execution::seq);
+	RegisterPartitionBenchmark(buckets, "pstl_par", pstl::execution::par);
+	RegisterPartitionBenchmark(buckets, "threads_par", threaded::execution::par);
+}
+
+static const bool PartitionBenchmarksRegistered = []() {
+	for (std::size_t buckets : { 2, 16, 256, 4096 })
+		RegisterPartitionBenchmarks(buckets);
+	return true;
+}();
@@ -0,0 +1,86 @@
+﻿#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/numeric>
+#include <pstl/execution>
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+#include "AlgorithmDispatch.h"
+#include "RunningStats.h"
+#include "SalesData.h"
+
+// Mean, variance, min and max of the BM_CountingIter profit column, either in one
+// transform_reduce with the mergeable RunningStats accumulator (a 40 byte reduction
+// type instead of the usual double), or in four passes: sum, sum of squares, min, max.
+// The single pass reads the data once but does more work per element; which one wins
+// depends on whether the column still fits in cache.
+
+template <typename Policy>
+static void BM_ProfitStatsSinglePass(benchmark::State& state, Policy execution_policy)
+{
+	const auto profit = GenProfit(state.range(0));
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		RunningStats stats = algo::transform_reduce(execution_policy, profit.begin(), profit.end(), RunningStats(),
+			RunningStats::Merge, RunningStats::FromValue);
+		benchmark::DoNotOptimize(stats);
+	}
+	state.SetBytesProcessed(state.iterations() * profit.size() * sizeof(double));
+}
+
+template <typename Policy>
+static void BM_ProfitStatsMultiPass(benchmark::State& state, Policy execution_policy)
+{
+	const auto profit = GenProfit(state.range(0));
+	const auto identity = [](double v) { return v; };
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		const double sum = algo::transform_reduce(execution_policy, profit.begin(), profit.end(), 0.0, std::plus<double>(), identity);
+		const double sumOfSquares = algo::transform_reduce(execution_policy, profit.begin(), profit.end(), 0.0, std::plus<double>(),
+			[](double v) { return v * v; });
+		const double min = algo::transform_reduce(execution_policy, profit.begin(), profit.end(), std::numeric_limits<double>::infinity(),
+			[](double a, double b) { return std::min(a, b); }, identity);
+		const double max = algo::transform_reduce(execution_policy, profit.begin(), profit.end(), -std::numeric_limits<double>::infinity(),
+			[](double a, double b) { return std::max(a, b); }, identity);
+
+		const double n = static_cast<double>(profit.size());
+		double mean = sum / n;
+		double variance = (sumOfSquares - sum * mean) / (n - 1.0);
+		benchmark::DoNotOptimize(mean);
+		benchmark::DoNotOptimize(variance);
+		benchmark::DoNotOptimize(min);
+		benchmark::DoNotOptimize(max);
+	}
+	state.SetBytesProcessed(state.iterations() * 4 * profit.size() * sizeof(double));
+}
+
+BENCHMARK_CAPTURE(BM_ProfitStatsSinglePass, std_seq, std::execution::seq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitStatsSinglePass, std_par, std::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitStatsSinglePass, std_par_unseq, std::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitStatsSinglePass, pstl_seq, pstl::execution::seq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitStatsSinglePass, pstl_unseq, pstl::execution::unseq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitStatsSinglePass, pstl_par, pstl::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitStatsSinglePass, pstl_par_unseq, pstl::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitStatsSinglePass, threads_par, threaded::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_ProfitStatsMultiPass, std_seq, std::execution::seq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitStatsMultiPass, std_par, std::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitStatsMultiPass, std_par_unseq, std::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitStatsMultiPass, pstl_seq, pstl::execution::seq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitStatsMultiPass, pstl_unseq, pstl::execution::unseq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitStatsMultiPass, pstl_par, pstl::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitStatsMultiPass, pstl_par_unseq, pstl::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitStatsMultiPass, threads_par, threaded::execution::par)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
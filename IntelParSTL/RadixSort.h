@@ -0,0 +1,66 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "BucketPartition.h"
+
+// LSD radix sort for integer keys, with the same policy interface as the algo::
+// wrappers: one stable bucket::Partition into 256 buckets per 8-bit digit, skipping
+// digits all keys share. Needs a contiguous range and n extra keys of memory.
+namespace radix
+{
+	constexpr int DigitBits = 8;
+	constexpr std::size_t Buckets = std::size_t(1) << DigitBits;
+
+	// Signed keys get their sign bit flipped so that the unsigned digits order them correctly.
+	template <typename Key>
+	std::size_t Digit(Key key, int shift)
+	{
+		using Bits = std::make_unsigned_t<Key>;
+		Bits bits = static_cast<Bits>(key);
+		if constexpr (std::is_signed_v<Key>)
+			bits ^= static_cast<Bits>(Bits(1) << (sizeof(Key) * 8 - 1));
+		return static_cast<std::size_t>((bits >> shift) & (Buckets - 1));
+	}
+
+	template <typename Policy, typename RandomIt>
+	void sort(Policy&& policy, RandomIt first, RandomIt last)
+	{
+		using Key = typename std::iterator_traits<RandomIt>::value_type;
+		static_assert(std::is_integral_v<Key>, "radix::sort handles integer keys only");
+
+		const std::ptrdiff_t n = std::distance(first, last);
+		if (n < 2)
+			return;
+
+		std::vector<Key> buffer(n);
+		Key* src = &*first;
+		Key* dst = buffer.data();
+		bucket::ChunkCounts counts(policy, n, Buckets);
+
+		for (int shift = 0; shift < static_cast<int>(sizeof(Key) * 8); shift += DigitBits)
+		{
+			auto digit = [shift](Key key) { return Digit(key, shift); };
+			bucket::Count(policy, src, counts, digit);
+
+			// all keys share this digit (narrow value ranges, high bytes of small ids)
+			bool trivial = false;
+			for (std::size_t d = 0; d < Buckets && !trivial; ++d)
+				trivial = counts.BucketTotal(d) == static_cast<std::size_t>(n);
+			if (trivial)
+				continue;
+
+			counts.ComputeOffsets();
+			bucket::Scatter(policy, src, dst, counts, digit);
+			std::swap(src, dst);
+		}
+
+		if (src != &*first)
+			std::copy(src, src + n, &*first);
+	}
+}
@@ -0,0 +1,35 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+
+inline float GenRandomFloat(float lower, float upper)
+{
+	// usage of thread local random engines allows running the generator in concurrent mode
+	thread_local static std::default_random_engine rd;
+	std::uniform_real_distribution<float> dist(lower, upper);
+	return dist(rd);
+}
+
+inline int GenRandomInt(int lower, int upper)
+{
+	// usage of thread local random engines allows running the generator in concurrent mode
+	thread_local static std::default_random_engine rd;
+	std::uniform_int_distribution<int> dist(lower, upper);
+	return dist(rd);
+}
+
+// Uniform over the whole range of an integer key type. uniform_int_distribution is not
+// defined for 8-bit types, so the draw is made in 64 bits and narrowed.
+template <typename Key>
+Key GenRandomKey()
+{
+	static_assert(std::is_integral<Key>::value, "integer keys only");
+	using Wide = std::conditional_t<std::is_signed<Key>::value, std::int64_t, std::uint64_t>;
+
+	thread_local static std::mt19937_64 rd;
+	std::uniform_int_distribution<Wide> dist(std::numeric_limits<Key>::min(), std::numeric_limits<Key>::max());
+	return static_cast<Key>(dist(rd));
+}
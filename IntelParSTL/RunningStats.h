@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+// Mergeable count / mean / variance / min / max accumulator (Welford for a single
+// value, Chan et al. for combining two partial results), so one transform_reduce
+// pass gives all of them:
+//
+//	auto stats = std::transform_reduce(policy, first, last, RunningStats(),
+//		RunningStats::Merge, RunningStats::FromValue);
+//
+// The merge is associative and commutative up to rounding, which is what the parallel
+// reduce requires, and unlike sum / sum of squares it does not lose the variance to
+// cancellation when the mean is large.
+struct RunningStats
+{
+	std::int64_t count = 0;
+	double mean = 0.0;
+	double m2 = 0.0; // sum of squared differences from the mean
+	double min = std::numeric_limits<double>::infinity();
+	double max = -std::numeric_limits<double>::infinity();
+
+	static RunningStats FromValue(double value)
+	{
+		return { 1, value, 0.0, value, value };
+	}
+
+	static RunningStats Merge(const RunningStats& a, const RunningStats& b)
+	{
+		if (a.count == 0)
+			return b;
+		if (b.count == 0)
+			return a;
+
+		RunningStats r;
+		r.count = a.count + b.count;
+		const double delta = b.mean - a.mean;
+		const double bShare = static_cast<double>(b.count) / r.count;
+		r.mean = a.mean + delta * bShare;
+		r.m2 = a.m2 + b.m2 + delta * delta * a.count * bShare;
+		r.min = std::min(a.min, b.min);
+		r.max = std::max(a.max, b.max);
+		return r;
+	}
+
+	// sample variance, 0 for fewer than two values
+	double Variance() const { return count > 1 ? m2 / (count - 1) : 0.0; }
+};
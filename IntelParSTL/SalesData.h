@@ -0,0 +1,117 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "ColumnEncoding.h"
+#include "ColumnTable.h"
+#include "RandomGen.h"
+
+// Random data for the sales table that BM_CountingIter models: one row per sale,
+// profit = price * (1 - discount) * quantity.
+
+inline std::vector<double> GenProfit(std::size_t count)
+{
+	std::vector<double> profit(count);
+	std::generate(profit.begin(), profit.end(), []() {
+		return (GenRandomFloat(0.5f, 100.0f) * (1.0f - GenRandomFloat(0.0f, 0.5f))) * GenRandomInt(1, 100);
+	});
+	return profit;
+}
+
+// Product id per sale, uniform over [0, productCount).
+inline std::vector<std::uint32_t> GenProductIds(std::size_t count, std::uint32_t productCount)
+{
+	std::vector<std::uint32_t> ids(count);
+	std::generate(ids.begin(), ids.end(), [productCount]() {
+		return static_cast<std::uint32_t>(GenRandomKey<std::uint32_t>() % productCount);
+	});
+	return ids;
+}
+
+// Product dimension table for the joins: ids 0 .. count - 1 in random order, so the
+// id is not the row, with one price and one category per product.
+struct ProductTable
+{
+	std::vector<std::uint32_t> ids;
+	std::vector<double> prices;
+	std::vector<std::uint32_t> categories;
+};
+
+inline ProductTable GenProductTable(std::uint32_t count, std::uint32_t categoryCount = 100)
+{
+	ProductTable products;
+	products.ids.resize(count);
+	std::iota(products.ids.begin(), products.ids.end(), 0u);
+	std::shuffle(products.ids.begin(), products.ids.end(), std::mt19937_64());
+	products.prices.resize(count);
+	std::generate(products.prices.begin(), products.prices.end(), []() { return GenRandomFloat(0.5f, 100.0f); });
+	products.categories.resize(count);
+	std::generate(products.categories.begin(), products.categories.end(), [categoryCount]() {
+		return static_cast<std::uint32_t>(GenRandomInt(0, static_cast<int>(categoryCount) - 1));
+	});
+	return products;
+}
+
+namespace sales
+{
+	struct Price : columnar::ColumnTag<double> { static constexpr const char* Name = "price"; };
+	struct Quantity : columnar::ColumnTag<unsigned int> { static constexpr const char* Name = "quantity"; };
+	struct Discount : columnar::ColumnTag<double> { static constexpr const char* Name = "discount"; };
+	struct Profit : columnar::ColumnTag<double> { static constexpr const char* Name = "profit"; };
+
+	using Table = columnar::ColumnTable<Price, Quantity, Discount, Profit>;
+
+	// narrow encodings of the same columns: float prices, byte quantities (1-100) and
+	// 8-bit fixed point discounts (0-0.5)
+	struct PriceF32 : columnar::ColumnTag<float> { static constexpr const char* Name = "price_f32"; };
+	struct QuantityU8 : columnar::ColumnTag<std::uint8_t> { static constexpr const char* Name = "quantity_u8"; };
+	struct DiscountQ8 : columnar::ColumnTag<std::uint8_t> { static constexpr const char* Name = "discount_q8"; };
+
+	using CompactTable = columnar::ColumnTable<PriceF32, QuantityU8, DiscountQ8, Profit>;
+
+	inline const FixedPoint8 DiscountCode(0.5f);
+
+	// the BM_CountingIter profit formula as a column expression
+	inline auto ProfitExpression()
+	{
+		using columnar::Col;
+		return (Col<Price>() * (1.0f - Col<Discount>())) * Col<Quantity>();
+	}
+
+	// the same on the compact table, decoding the discount inline
+	inline auto CompactProfitExpression()
+	{
+		using columnar::Col;
+		return (Col<PriceF32>() * (1.0f - Col<DiscountQ8>() * DiscountCode.step)) * Col<QuantityU8>();
+	}
+}
+
+// Same value ranges as BM_CountingIter; profit is left at zero.
+inline sales::Table GenSalesTable(std::size_t rows)
+{
+	sales::Table table(rows);
+	auto& prices = table.Get<sales::Price>();
+	auto& quantities = table.Get<sales::Quantity>();
+	auto& discounts = table.Get<sales::Discount>();
+	std::generate(prices.begin(), prices.end(), []() { return GenRandomFloat(0.5f, 100.0f); });
+	std::generate(quantities.begin(), quantities.end(), []() { return GenRandomInt(1, 100); });
+	std::generate(discounts.begin(), discounts.end(), []() { return GenRandomFloat(0.0f, 0.5f); }); // max 50%
+	return table;
+}
+
+inline sales::CompactTable EncodeCompact(const sales::Table& table)
+{
+	sales::CompactTable compact(table.Rows());
+	const auto& prices = table.Get<sales::Price>();
+	const auto& quantities = table.Get<sales::Quantity>();
+	const auto& discounts = table.Get<sales::Discount>();
+	std::transform(prices.begin(), prices.end(), compact.Get<sales::PriceF32>().begin(), [](double p) { return static_cast<float>(p); });
+	std::transform(quantities.begin(), quantities.end(), compact.Get<sales::QuantityU8>().begin(), [](unsigned int q) { return static_cast<std::uint8_t>(q); });
+	std::transform(discounts.begin(), discounts.end(), compact.Get<sales::DiscountQ8>().begin(), [](double d) { return sales::DiscountCode.Encode(d); });
+	return compact;
+}
@@ -0,0 +1,123 @@
+﻿#include <cstdint>
+#include <execution>
+#include <functional>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/numeric>
+#include <pstl/execution>
+#include <pstl/iterators.h>
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+#include "AlgorithmDispatch.h"
+#include "SalesData.h"
+
+// The columnar table (ColumnTable.h) against the loose vectors of BM_CountingIter, on
+// the same data. Any gap between a *Raw and its *Columns benchmark is overhead of the
+// abstraction; the generation of the data is not timed.
+//	Profit   profit = price * (1 - discount) * quantity, written to a fourth column
+//	Revenue  sum of price * quantity, a read-only scan over a projection
+
+template <typename Policy>
+static void BM_ProfitRaw(benchmark::State& state, Policy execution_policy)
+{
+	const auto table = GenSalesTable(state.range(0));
+	const std::vector<double> prices(table.Get<sales::Price>().begin(), table.Get<sales::Price>().end());
+	const std::vector<unsigned int> quantities(table.Get<sales::Quantity>().begin(), table.Get<sales::Quantity>().end());
+	const std::vector<double> discounts(table.Get<sales::Discount>().begin(), table.Get<sales::Discount>().end());
+	std::vector<double> profit(prices.size());
+	const auto VecSize = static_cast<int64_t>(prices.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		algo::transform(execution_policy, pstl::counting_iterator<int64_t>(0), pstl::counting_iterator(VecSize), profit.begin(),
+			[&prices, &quantities, &discounts](auto i) {
+			return (prices[i] * (1.0f - discounts[i]))*quantities[i];
+		});
+		benchmark::ClobberMemory();
+	}
+}
+
+template <typename Policy>
+static void BM_ProfitColumns(benchmark::State& state, Policy execution_policy)
+{
+	auto table = GenSalesTable(state.range(0));
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		table.Compute<sales::Profit>(execution_policy, sales::ProfitExpression());
+		benchmark::ClobberMemory();
+	}
+}
+
+template <typename Policy>
+static void BM_RevenueRaw(benchmark::State& state, Policy execution_policy)
+{
+	const auto table = GenSalesTable(state.range(0));
+	const std::vector<double> prices(table.Get<sales::Price>().begin(), table.Get<sales::Price>().end());
+	const std::vector<unsigned int> quantities(table.Get<sales::Quantity>().begin(), table.Get<sales::Quantity>().end());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		double revenue = algo::transform_reduce(execution_policy, prices.begin(), prices.end(), quantities.begin(), 0.0,
+			std::plus<double>(), [](double price, unsigned int quantity) { return price * quantity; });
+		benchmark::DoNotOptimize(revenue);
+	}
+}
+
+template <typename Policy>
+static void BM_RevenueColumns(benchmark::State& state, Policy execution_policy)
+{
+	const auto table = GenSalesTable(state.range(0));
+	const auto view = table.Select<sales::Price, sales::Quantity>();
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		double revenue = view.TransformReduce(execution_policy, 0.0, std::plus<double>(),
+			[](double price, unsigned int quantity) { return price * quantity; });
+		benchmark::DoNotOptimize(revenue);
+	}
+}
+
+BENCHMARK_CAPTURE(BM_ProfitRaw, std_seq, std::execution::seq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitRaw, std_par, std::execution::par)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitRaw, std_par_unseq, std::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitRaw, pstl_seq, pstl::execution::seq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitRaw, pstl_unseq, pstl::execution::unseq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitRaw, pstl_par, pstl::execution::par)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitRaw, pstl_par_unseq, pstl::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitRaw, threads_par, threaded::execution::par)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_ProfitColumns, std_seq, std::execution::seq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitColumns, std_par, std::execution::par)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitColumns, std_par_unseq, std::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitColumns, pstl_seq, pstl::execution::seq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitColumns, pstl_unseq, pstl::execution::unseq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitColumns, pstl_par, pstl::execution::par)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitColumns, pstl_par_unseq, pstl::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ProfitColumns, threads_par, threaded::execution::par)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_RevenueRaw, std_seq, std::execution::seq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RevenueRaw, std_par, std::execution::par)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RevenueRaw, std_par_unseq, std::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RevenueRaw, pstl_seq, pstl::execution::seq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RevenueRaw, pstl_unseq, pstl::execution::unseq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RevenueRaw, pstl_par, pstl::execution::par)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RevenueRaw, pstl_par_unseq, pstl::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RevenueRaw, threads_par, threaded::execution::par)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_RevenueColumns, std_seq, std::execution::seq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RevenueColumns, std_par, std::execution::par)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RevenueColumns, std_par_unseq, std::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RevenueColumns, pstl_seq, pstl::execution::seq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RevenueColumns, pstl_unseq, pstl::execution::unseq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RevenueColumns, pstl_par, pstl::execution::par)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RevenueColumns, pstl_par_unseq, pstl::execution::par_unseq)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RevenueColumns, threads_par, threaded::execution::par)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
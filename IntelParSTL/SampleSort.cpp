@@ -0,0 +1,132 @@
+﻿#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/execution>
+
+#include "glm/vec4.hpp" // glm::vec4
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+#include "AlgorithmDispatch.h"
+#include "RandomGen.h"
+#include "SampleSort.h"
+
+// sample::sort against algo::sort at the sizes where the library sorts are expected to
+// stop scaling: the BM_SortPoints points (glm::vec4 by x) up to 1e7 and uint32 / uint64
+// keys up to 1e8. Scaling over worker counts comes from the driver, e.g.
+// --threads=1,2,4,8,16,32,64 or --scaling_report.
+//
+// Inputs are restored from a random copy every iteration, like BM_SortKeys; the copy is
+// a parallel one so it doesn't flatten the curves at high thread counts, and it is in
+// both columns. The 1e8 uint64 run needs about 2.4 GB (input, copy, sample sort buffer
+// and bucket ids). The points stop at 1e7 for the same reason: 1e8 16-byte points would
+// need about 5 GB.
+
+struct PointsByX
+{
+	bool operator()(const glm::vec4& a, const glm::vec4& b) const { return a.x < b.x; }
+};
+
+template <typename T>
+struct SortInput;
+
+template <>
+struct SortInput<glm::vec4>
+{
+	using Compare = PointsByX;
+	static glm::vec4 Generate()
+	{
+		return glm::vec4(GenRandomFloat(-1.0f, 1.0f), GenRandomFloat(-1.0f, 1.0f), GenRandomFloat(-1.0f, 1.0f), 1.0f);
+	}
+};
+
+template <>
+struct SortInput<std::uint32_t>
+{
+	using Compare = std::less<>;
+	static std::uint32_t Generate() { return GenRandomKey<std::uint32_t>(); }
+};
+
+template <>
+struct SortInput<std::uint64_t>
+{
+	using Compare = std::less<>;
+	static std::uint64_t Generate() { return GenRandomKey<std::uint64_t>(); }
+};
+
+template <typename T>
+static std::vector<T> GenSortInput(std::size_t count)
+{
+	std::vector<T> input(count);
+	std::generate(pstl::execution::par, input.begin(), input.end(), []() { return SortInput<T>::Generate(); });
+	return input;
+}
+
+template <typename T, typename Policy>
+static void BM_AlgoSort(benchmark::State& state, Policy execution_policy)
+{
+	const auto input = GenSortInput<T>(state.range(0));
+	std::vector<T> values(input.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::copy(pstl::execution::par, input.begin(), input.end(), values.begin());
+		algo::sort(execution_policy, values.begin(), values.end(), typename SortInput<T>::Compare());
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(state.iterations() * input.size() * sizeof(T));
+}
+
+template <typename T, typename Policy>
+static void BM_SampleSort(benchmark::State& state, Policy execution_policy)
+{
+	const auto input = GenSortInput<T>(state.range(0));
+	std::vector<T> values(input.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::copy(pstl::execution::par, input.begin(), input.end(), values.begin());
+		sample::sort(execution_policy, values.begin(), values.end(), typename SortInput<T>::Compare());
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(state.iterations() * input.size() * sizeof(T));
+}
+
+// element type in the name, as for the integer key benchmarks: BM_SampleSort<points>/pstl_par/1000000
+template <typename T, typename Policy>
+static void RegisterSortBenchmarks(const std::string& typeName, const std::string& policyName, Policy policy, int maxSize)
+{
+	const std::string suffix = "<" + typeName + ">/" + policyName;
+	benchmark::RegisterBenchmark(("BM_AlgoSort" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_AlgoSort<T>(state, policy); })
+		->RangeMultiplier(10)->Range(100000, maxSize)->Unit(benchmark::kMillisecond);
+	benchmark::RegisterBenchmark(("BM_SampleSort" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_SampleSort<T>(state, policy); })
+		->RangeMultiplier(10)->Range(100000, maxSize)->Unit(benchmark::kMillisecond);
+}
+
+template <typename T>
+static void RegisterSortBenchmarks(const std::string& typeName, int maxSize)
+{
+	RegisterSortBenchmarks<T>(typeName, "std_seq", std::execution::seq, maxSize);
+	RegisterSortBenchmarks<T>(typeName, "std_par", std::execution::par, maxSize);
+	RegisterSortBenchmarks<T>(typeName, "pstl_seq", pstl::execution::seq, maxSize);
+	RegisterSortBenchmarks<T>(typeName, "pstl_par", pstl::execution::par, maxSize);
+	RegisterSortBenchmarks<T>(typeName, "threads_par", threaded::execution::par, maxSize);
+}
+
+static const bool SortBenchmarksRegistered = []() {
+	RegisterSortBenchmarks<glm::vec4>("points", 10000000);
+	RegisterSortBenchmarks<std::uint32_t>("uint32", 100000000);
+	RegisterSortBenchmarks<std::uint64_t>("uint64", 100000000);
+	return true;
+}();
@@ -0,0 +1,157 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "BucketPartition.h"
+
+// Parallel sample sort, with the same policy interface as radix::sort but for any
+// comparator:
+//	1. sort an oversampled random sample and take every Oversampling-th element as a
+//	   splitter, k - 1 splitters for k buckets
+//	2. classify every element with a branchless descent of the splitter tree, keeping
+//	   the bucket ids so the scatter doesn't classify again
+//	3. bucket::Count / Scatter into a buffer
+//	4. sort the buckets independently and copy them back, one task per bucket
+// Elements equal to a splitter get a bucket of their own that needs no sorting, so
+// many duplicate keys don't pile up in one bucket. Small inputs go to std::sort.
+// Needs a contiguous range and n extra elements of memory.
+namespace sample
+{
+	constexpr std::size_t MaxBuckets = 1024;
+	constexpr std::ptrdiff_t MinBucketSize = 4096;
+	constexpr std::size_t Oversampling = 32;
+
+	// Sorted splitters as an implicit binary tree (children of node j at 2j and 2j + 1,
+	// root at 1), descended without branches: log2(k) dependent compares per element.
+	// Element v lands in bucket b with s[b - 1] < v <= s[b]; the classification splits
+	// that into 2b (v < s[b]) and 2b + 1 (v == s[b]), 2k buckets in total.
+	template <typename T, typename Compare>
+	class SplitterTree
+	{
+	public:
+		// splitters sorted, buckets - 1 of them, buckets a power of two
+		SplitterTree(const std::vector<T>& splitters, std::size_t buckets, Compare comp)
+			: buckets_(buckets), tree_(buckets), upper_(buckets), comp_(comp)
+		{
+			std::size_t next = 0;
+			Fill(1, splitters, next);
+			while ((std::size_t(1) << levels_) < buckets)
+				++levels_;
+
+			std::copy(splitters.begin(), splitters.end(), upper_.begin());
+			upper_.back() = splitters.back(); // the last bucket has no upper splitter, masked out below
+		}
+
+		std::size_t Buckets() const { return 2 * buckets_; }
+
+		std::size_t Bucket(const T& v) const
+		{
+			std::size_t j = 1;
+			for (int level = 0; level < levels_; ++level)
+				j = 2 * j + static_cast<std::size_t>(comp_(tree_[j], v));
+			const std::size_t b = j - buckets_;
+			const bool equal = (b + 1 < buckets_) & !comp_(v, upper_[b]);
+			return 2 * b + static_cast<std::size_t>(equal);
+		}
+
+	private:
+		// in-order walk of the tree takes the splitters in sorted order
+		void Fill(std::size_t node, const std::vector<T>& splitters, std::size_t& next)
+		{
+			if (node >= buckets_)
+				return;
+			Fill(2 * node, splitters, next);
+			tree_[node] = splitters[next++];
+			Fill(2 * node + 1, splitters, next);
+		}
+
+		std::size_t buckets_;
+		int levels_ = 0;
+		std::vector<T> tree_;
+		std::vector<T> upper_;
+		Compare comp_;
+	};
+
+	// Power of two bucket count: buckets of about MinBucketSize elements, at most MaxBuckets.
+	inline std::size_t BucketCount(std::ptrdiff_t n)
+	{
+		std::size_t buckets = 2;
+		while (buckets < MaxBuckets && static_cast<std::ptrdiff_t>(buckets) * MinBucketSize < n)
+			buckets *= 2;
+		return buckets;
+	}
+
+	// Splitters from a sorted sample drawn with a fixed seed, so every run of a benchmark
+	// classifies the same way.
+	template <typename T, typename Compare>
+	std::vector<T> ChooseSplitters(const T* data, std::ptrdiff_t n, std::size_t buckets, Compare comp)
+	{
+		std::mt19937_64 rng(buckets);
+		std::uniform_int_distribution<std::ptrdiff_t> index(0, n - 1);
+		std::vector<T> samples(Oversampling * buckets);
+		for (auto& s : samples)
+			s = data[index(rng)];
+		std::sort(samples.begin(), samples.end(), comp);
+
+		std::vector<T> splitters(buckets - 1);
+		for (std::size_t i = 0; i < splitters.size(); ++i)
+			splitters[i] = samples[(i + 1) * Oversampling - 1];
+		return splitters;
+	}
+
+	template <typename Policy, typename RandomIt, typename Compare>
+	void sort(Policy&& policy, RandomIt first, RandomIt last, Compare comp)
+	{
+		using T = typename std::iterator_traits<RandomIt>::value_type;
+
+		const std::ptrdiff_t n = std::distance(first, last);
+		if (n < 2 * MinBucketSize)
+		{
+			std::sort(first, last, comp);
+			return;
+		}
+
+		T* data = &*first;
+		const SplitterTree<T, Compare> tree(ChooseSplitters(data, n, BucketCount(n), comp), BucketCount(n), comp);
+
+		std::vector<std::uint16_t> bucketIds(n);
+		std::vector<T> buffer(n);
+		bucket::ChunkCounts counts(policy, n, tree.Buckets());
+		bucket::Count(policy, data, counts, [data, &tree, &bucketIds](const T& v) {
+			const std::size_t b = tree.Bucket(v);
+			bucketIds[&v - data] = static_cast<std::uint16_t>(b);
+			return b;
+		});
+		const auto bucketBegin = counts.ComputeOffsets();
+		bucket::Scatter(policy, data, buffer.data(), counts, [data, &bucketIds](const T& v) { return bucketIds[&v - data]; });
+
+		// threaded: one thread per worker taking every workers-th bucket; pstl / std: one
+		// task per bucket, left to the scheduler
+		const std::ptrdiff_t buckets = static_cast<std::ptrdiff_t>(tree.Buckets());
+		const std::ptrdiff_t tasks = algo::IsSequential<Policy> ? 1
+			: algo::IsThreaded<Policy> ? std::min(threaded::WorkerCount(), buckets) : buckets;
+		bucket::ForEachChunk(policy, tasks, [&](std::ptrdiff_t task) {
+			for (std::ptrdiff_t b = task; b < buckets; b += tasks)
+			{
+				T* begin = buffer.data() + bucketBegin[b];
+				T* end = buffer.data() + bucketBegin[b + 1];
+				if (b % 2 == 0)
+					std::sort(begin, end, comp);
+				std::copy(begin, end, data + bucketBegin[b]);
+			}
+		});
+	}
+
+	template <typename Policy, typename RandomIt>
+	void sort(Policy&& policy, RandomIt first, RandomIt last)
+	{
+		sample::sort(std::forward<Policy>(policy), first, last, std::less<>());
+	}
+}
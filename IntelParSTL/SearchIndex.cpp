@@ -0,0 +1,190 @@
+﻿#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <string>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/execution>
+#include <pstl/iterators.h>
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+#include "AlgorithmDispatch.h"
+#include "RandomGen.h"
+#include "SearchIndex.h"
+
+// lower_bound queries against the sorted x coordinates of the BM_SortPoints points:
+// std::lower_bound on the sorted array versus the Eytzinger and B-tree layouts of
+// SearchIndex.h. 4K keys fit in L1, 64K in L2, 1M in a typical LLC and 16M in none.
+// Every iteration answers QueryCount random queries, handed to the index in batches of
+// the size in the kernel name (BM_SearchBTree<1024>/pstl_par/65536): small batches pay
+// the policy's dispatch per batch and leave the interleaved search little to overlap.
+//
+// Counters: lookups (queries per second), bytes/key (index memory, ranks included).
+
+constexpr std::size_t QueryCount = 1 << 18;
+
+static std::vector<float> GenSortedKeys(std::size_t count)
+{
+	std::vector<float> keys(count);
+	std::generate(keys.begin(), keys.end(), []() { return GenRandomFloat(-1.0f, 1.0f); });
+	std::sort(pstl::execution::par, keys.begin(), keys.end());
+	return keys;
+}
+
+static std::vector<float> GenQueries()
+{
+	std::vector<float> queries(QueryCount);
+	std::generate(queries.begin(), queries.end(), []() { return GenRandomFloat(-1.0f, 1.0f); });
+	return queries;
+}
+
+// search(first query, count, first result) once per batch
+template <typename Search>
+static void SearchInBatches(const std::vector<float>& queries, std::size_t batch, std::vector<std::uint32_t>& out, Search search)
+{
+	for (std::size_t begin = 0; begin < queries.size(); begin += batch)
+		search(queries.data() + begin, std::min(batch, queries.size() - begin), out.data() + begin);
+}
+
+static void SetSearchCounters(benchmark::State& state, std::size_t bytes, std::size_t keys)
+{
+	state.counters["lookups"] = benchmark::Counter(static_cast<double>(QueryCount), benchmark::Counter::kIsIterationInvariantRate);
+	state.counters["bytes/key"] = static_cast<double>(bytes) / keys;
+}
+
+template <typename Policy>
+static void BM_SearchLowerBound(benchmark::State& state, int batchSize, Policy execution_policy)
+{
+	const auto keys = GenSortedKeys(state.range(0));
+	const auto queries = GenQueries();
+	const auto batch = static_cast<std::size_t>(batchSize);
+	std::vector<std::uint32_t> out(queries.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		SearchInBatches(queries, batch, out, [&](const float* first, std::size_t count, std::uint32_t* result) {
+			algo::transform(execution_policy, first, first + count, result, [&keys](float key) {
+				return static_cast<std::uint32_t>(std::lower_bound(keys.begin(), keys.end(), key) - keys.begin());
+			});
+		});
+		benchmark::ClobberMemory();
+	}
+	SetSearchCounters(state, keys.size() * sizeof(float), keys.size());
+}
+
+template <typename Policy>
+static void BM_SearchEytzinger(benchmark::State& state, int batchSize, Policy execution_policy)
+{
+	const search::EytzingerIndex<float> index(pstl::execution::par, GenSortedKeys(state.range(0)));
+	const auto queries = GenQueries();
+	const auto batch = static_cast<std::size_t>(batchSize);
+	std::vector<std::uint32_t> out(queries.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		SearchInBatches(queries, batch, out, [&](const float* first, std::size_t count, std::uint32_t* result) {
+			index.LowerBounds(execution_policy, first, count, result);
+		});
+		benchmark::ClobberMemory();
+	}
+	SetSearchCounters(state, index.MemoryBytes(), index.Size());
+}
+
+template <typename Policy>
+static void BM_SearchBTree(benchmark::State& state, int batchSize, Policy execution_policy)
+{
+	const search::BTreeIndex<float> index(pstl::execution::par, GenSortedKeys(state.range(0)));
+	const auto queries = GenQueries();
+	const auto batch = static_cast<std::size_t>(batchSize);
+	std::vector<std::uint32_t> out(queries.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		SearchInBatches(queries, batch, out, [&](const float* first, std::size_t count, std::uint32_t* result) {
+			index.LowerBounds(execution_policy, first, count, result);
+		});
+		benchmark::ClobberMemory();
+	}
+	SetSearchCounters(state, index.MemoryBytes(), index.Size());
+}
+
+template <typename Policy>
+static void BM_BuildEytzinger(benchmark::State& state, Policy execution_policy)
+{
+	const auto keys = GenSortedKeys(state.range(0));
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		search::EytzingerIndex<float> index(execution_policy, keys);
+		benchmark::DoNotOptimize(index);
+	}
+	state.counters["keys"] = benchmark::Counter(static_cast<double>(keys.size()), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template <typename Policy>
+static void BM_BuildBTree(benchmark::State& state, Policy execution_policy)
+{
+	const auto keys = GenSortedKeys(state.range(0));
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		search::BTreeIndex<float> index(execution_policy, keys);
+		benchmark::DoNotOptimize(index);
+	}
+	state.counters["keys"] = benchmark::Counter(static_cast<double>(keys.size()), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// batch size in the name, index size as the argument
+template <typename Policy>
+static void RegisterSearchBenchmarks(int batch, const std::string& policyName, Policy policy)
+{
+	const std::string suffix = "<" + std::to_string(batch) + ">/" + policyName;
+	benchmark::RegisterBenchmark(("BM_SearchLowerBound" + suffix).c_str(),
+		[batch, policy](benchmark::State& state) { BM_SearchLowerBound(state, batch, policy); })
+		->RangeMultiplier(16)->Range(1 << 12, 1 << 24)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_SearchEytzinger" + suffix).c_str(),
+		[batch, policy](benchmark::State& state) { BM_SearchEytzinger(state, batch, policy); })
+		->RangeMultiplier(16)->Range(1 << 12, 1 << 24)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_SearchBTree" + suffix).c_str(),
+		[batch, policy](benchmark::State& state) { BM_SearchBTree(state, batch, policy); })
+		->RangeMultiplier(16)->Range(1 << 12, 1 << 24)->Unit(benchmark::kMicrosecond);
+}
+
+// the SIMD is inside the node compare, the searches are chains of dependent loads that
+// unseq can't vectorise, so seq and par only
+static void RegisterSearchBenchmarks(int batch)
+{
+	RegisterSearchBenchmarks(batch, "std_seq", std::execution::seq);
+	RegisterSearchBenchmarks(batch, "std_par", std::execution::par);
+	RegisterSearchBenchmarks(batch, "pstl_seq", pstl::execution::seq);
+	RegisterSearchBenchmarks(batch, "pstl_par", pstl::execution::par);
+	RegisterSearchBenchmarks(batch, "threads_par", threaded::execution::par);
+}
+
+static const bool SearchBenchmarksRegistered = []() {
+	for (int batch : { 16, 1024, static_cast<int>(QueryCount) })
+		RegisterSearchBenchmarks(batch);
+	return true;
+}();
+
+BENCHMARK_CAPTURE(BM_BuildEytzinger, std_seq, std::execution::seq)->RangeMultiplier(16)->Range(1 << 12, 1 << 24)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_BuildEytzinger, std_par, std::execution::par)->RangeMultiplier(16)->Range(1 << 12, 1 << 24)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_BuildEytzinger, pstl_seq, pstl::execution::seq)->RangeMultiplier(16)->Range(1 << 12, 1 << 24)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_BuildEytzinger, pstl_par, pstl::execution::par)->RangeMultiplier(16)->Range(1 << 12, 1 << 24)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_BuildEytzinger, threads_par, threaded::execution::par)->RangeMultiplier(16)->Range(1 << 12, 1 << 24)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_BuildBTree, std_seq, std::execution::seq)->RangeMultiplier(16)->Range(1 << 12, 1 << 24)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_BuildBTree, std_par, std::execution::par)->RangeMultiplier(16)->Range(1 << 12, 1 << 24)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_BuildBTree, pstl_seq, pstl::execution::seq)->RangeMultiplier(16)->Range(1 << 12, 1 << 24)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_BuildBTree, pstl_par, pstl::execution::par)->RangeMultiplier(16)->Range(1 << 12, 1 << 24)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_BuildBTree, threads_par, threaded::execution::par)->RangeMultiplier(16)->Range(1 << 12, 1 << 24)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,321 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#if defined(_MSC_VER) || defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <pstl/iterators.h>
+
+#include "AlgorithmDispatch.h"
+#include "ColumnTable.h"
+
+// Static search indexes over sorted keys that answer lower_bound queries with fewer
+// cache misses than a binary search over the sorted array, which touches a new cache
+// line on almost every level:
+//	EytzingerIndex  the keys of a binary search tree in BFS order, so the next four
+//	                levels of a search sit in one cache line that can be prefetched
+//	BTreeIndex      an implicit B-tree of 64-byte nodes of 16 keys, one cache line and
+//	                one SIMD compare per level, log17(n) levels
+// Both are built from the sorted keys in parallel (every slot works out its rank in
+// the sorted order on its own), keep that rank next to every key, and return the same
+// position std::lower_bound would. LowerBounds answers a batch of queries under a
+// policy, searching InterleavedQueries of them in lockstep so that their cache misses
+// overlap, with a software prefetch of the next level.
+namespace search
+{
+	// queries searched in lockstep by the batched lookups
+	constexpr std::size_t InterleavedQueries = 16;
+
+	inline void PrefetchRead(const void* address)
+	{
+#if defined(_MSC_VER) || defined(__SSE2__)
+		_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+		__builtin_prefetch(address);
+#endif
+	}
+
+	// fills the slots of a node past the last key, sorts after every real key
+	template <typename Key>
+	constexpr Key PaddingKey()
+	{
+		return std::numeric_limits<Key>::has_infinity ? std::numeric_limits<Key>::infinity() : std::numeric_limits<Key>::max();
+	}
+
+	// Implicit tree of nodes with SlotCount keys each, node k's children are
+	// k * (SlotCount + 1) + 1 + t, t in [0, SlotCount]; nodes >= nodeCount don't exist.
+	template <std::size_t SlotCount>
+	std::size_t ChildNode(std::size_t node, std::size_t t)
+	{
+		return node * (SlotCount + 1) + 1 + t;
+	}
+
+	template <std::size_t SlotCount>
+	std::size_t SubtreeNodes(std::size_t node, std::size_t nodeCount)
+	{
+		std::size_t nodes = 0;
+		for (std::size_t lo = node, hi = node; lo < nodeCount; lo = ChildNode<SlotCount>(lo, 0), hi = ChildNode<SlotCount>(hi, SlotCount))
+			nodes += std::min(hi, nodeCount - 1) - lo + 1;
+		return nodes;
+	}
+
+	// In-order rank of the first slot of a node, i.e. the number of slots that come
+	// before it in sorted order: its first child's subtree, plus for every ancestor the
+	// children and slots left of the path.
+	template <std::size_t SlotCount>
+	std::size_t FirstSlotRank(std::size_t node, std::size_t nodeCount)
+	{
+		std::size_t rank = SubtreeNodes<SlotCount>(ChildNode<SlotCount>(node, 0), nodeCount) * SlotCount;
+		for (std::size_t k = node; k > 0; k = (k - 1) / (SlotCount + 1))
+		{
+			const std::size_t parent = (k - 1) / (SlotCount + 1);
+			const std::size_t t = (k - 1) % (SlotCount + 1);
+			for (std::size_t u = 0; u < t; ++u)
+				rank += SubtreeNodes<SlotCount>(ChildNode<SlotCount>(parent, u), nodeCount) * SlotCount;
+			rank += t;
+		}
+		return rank;
+	}
+
+	// fill(node, slot, rank) over a subtree in order, starting at rank; returns the
+	// rank after the subtree
+	template <std::size_t SlotCount, typename Fill>
+	std::size_t FillInOrder(std::size_t node, std::size_t nodeCount, std::size_t rank, const Fill& fill)
+	{
+		if (node >= nodeCount)
+			return rank;
+		for (std::size_t j = 0; j < SlotCount; ++j)
+		{
+			rank = FillInOrder<SlotCount>(ChildNode<SlotCount>(node, j), nodeCount, rank, fill);
+			fill(node, j, rank++);
+		}
+		return FillInOrder<SlotCount>(ChildNode<SlotCount>(node, SlotCount), nodeCount, rank, fill);
+	}
+
+	// Calls fill(node, slot, rank) for every slot with its in-order rank. The nodes above
+	// the first level with FrontierNodes nodes work out their ranks one by one, every
+	// node of that level then fills its whole subtree in order, which is a contiguous
+	// range of ranks.
+	constexpr std::size_t FrontierNodes = 4096;
+
+	template <std::size_t SlotCount, typename Policy, typename Fill>
+	void ForEachSlotRank(Policy&& policy, std::size_t nodeCount, Fill fill)
+	{
+		std::size_t frontierBegin = 0, frontierEnd = 1;
+		while (frontierEnd - frontierBegin < FrontierNodes && frontierBegin < nodeCount)
+		{
+			frontierBegin = frontierEnd;
+			frontierEnd = ChildNode<SlotCount>(frontierEnd - 1, SlotCount) + 1;
+		}
+		frontierBegin = std::min(frontierBegin, nodeCount);
+		frontierEnd = std::min(frontierEnd, nodeCount);
+
+		algo::for_each(policy, pstl::counting_iterator<std::size_t>(0), pstl::counting_iterator<std::size_t>(frontierBegin),
+			[nodeCount, &fill](std::size_t node) {
+			std::size_t rank = FirstSlotRank<SlotCount>(node, nodeCount);
+			for (std::size_t j = 0; j < SlotCount; ++j)
+			{
+				fill(node, j, rank);
+				// the next slot comes after child j + 1's subtree
+				rank += SubtreeNodes<SlotCount>(ChildNode<SlotCount>(node, j + 1), nodeCount) * SlotCount + 1;
+			}
+		});
+		algo::for_each(policy, pstl::counting_iterator<std::size_t>(frontierBegin), pstl::counting_iterator<std::size_t>(frontierEnd),
+			[nodeCount, &fill](std::size_t node) {
+			// the subtree starts with the first child's subtree, in front of the first slot
+			const std::size_t subtreeRank = FirstSlotRank<SlotCount>(node, nodeCount) - SubtreeNodes<SlotCount>(ChildNode<SlotCount>(node, 0), nodeCount) * SlotCount;
+			FillInOrder<SlotCount>(node, nodeCount, subtreeRank, fill);
+		});
+	}
+
+	template <typename Key>
+	class EytzingerIndex
+	{
+	public:
+		// sorted must be in ascending order
+		template <typename Policy>
+		EytzingerIndex(Policy&& policy, const std::vector<Key>& sorted)
+			: size_(sorted.size()), keys_(sorted.size() + 1), ranks_(sorted.size() + 1)
+		{
+			// slot k + 1 holds node k of the 0-based binary tree
+			Key* keys = keys_.data();
+			std::uint32_t* ranks = ranks_.data();
+			const Key* source = sorted.data();
+			ForEachSlotRank<1>(std::forward<Policy>(policy), size_, [keys, ranks, source](std::size_t node, std::size_t, std::size_t rank) {
+				keys[node + 1] = source[rank];
+				ranks[node + 1] = static_cast<std::uint32_t>(rank);
+			});
+		}
+
+		std::size_t Size() const { return size_; }
+		std::size_t MemoryBytes() const { return keys_.size() * sizeof(Key) + ranks_.size() * sizeof(std::uint32_t); }
+
+		std::size_t LowerBound(Key key) const
+		{
+			std::size_t k = 1;
+			while (k <= size_)
+			{
+				PrefetchRead(keys_.data() + std::min(k * 16, size_));
+				k = 2 * k + (keys_[k] < key ? 1 : 0);
+			}
+			return Rank(k);
+		}
+
+		// out[i] = LowerBound(queries[i])
+		template <typename Policy>
+		void LowerBounds(Policy&& policy, const Key* queries, std::size_t count, std::uint32_t* out) const
+		{
+			const std::size_t groups = (count + InterleavedQueries - 1) / InterleavedQueries;
+			algo::for_each(std::forward<Policy>(policy), pstl::counting_iterator<std::size_t>(0), pstl::counting_iterator<std::size_t>(groups),
+				[this, queries, count, out](std::size_t group) {
+				const std::size_t begin = group * InterleavedQueries;
+				const std::size_t size = std::min(InterleavedQueries, count - begin);
+				std::size_t k[InterleavedQueries];
+				std::fill(k, k + size, std::size_t(1));
+
+				// once past the leaves a search keeps going right, which the decoding in Rank ignores
+				for (std::size_t level = 0; (std::size_t(1) << level) <= size_; ++level)
+				{
+					for (std::size_t q = 0; q < size; ++q)
+					{
+						const Key node = keys_[std::min(k[q], size_)];
+						k[q] = 2 * k[q] + (k[q] > size_ || node < queries[begin + q] ? 1 : 0);
+						PrefetchRead(keys_.data() + std::min(k[q] * 16, size_));
+					}
+				}
+				for (std::size_t q = 0; q < size; ++q)
+					out[begin + q] = static_cast<std::uint32_t>(Rank(k[q]));
+			});
+		}
+
+	private:
+		// The path bits of k record the turns, 1 for right. The answer is the node of
+		// the last left turn: drop the trailing right turns and that left turn.
+		std::size_t Rank(std::size_t k) const
+		{
+			while (k & 1)
+				k >>= 1;
+			k >>= 1;
+			return k == 0 ? size_ : ranks_[k];
+		}
+
+		std::size_t size_;
+		// 64-byte aligned, so with 4-byte keys the 16 great-great-grandchildren of k share a line
+		columnar::Column<Key> keys_;
+		std::vector<std::uint32_t> ranks_;
+	};
+
+	// Number of keys of the node that are less than key (keys within a node ascend).
+	template <typename Key, std::size_t SlotCount>
+	std::size_t CountLess(const Key* node, Key key)
+	{
+		std::size_t count = 0;
+		for (std::size_t j = 0; j < SlotCount; ++j)
+			count += node[j] < key ? 1 : 0;
+		return count;
+	}
+
+#if defined(_MSC_VER) || defined(__SSE2__)
+	// four 4-wide compares; each true lane is -1, so subtracting them counts
+	template <>
+	inline std::size_t CountLess<float, 16>(const float* node, float key)
+	{
+		const __m128 k = _mm_set1_ps(key);
+		__m128i count = _mm_setzero_si128();
+		for (int j = 0; j < 16; j += 4)
+			count = _mm_sub_epi32(count, _mm_castps_si128(_mm_cmplt_ps(_mm_load_ps(node + j), k)));
+		count = _mm_add_epi32(count, _mm_shuffle_epi32(count, _MM_SHUFFLE(1, 0, 3, 2)));
+		count = _mm_add_epi32(count, _mm_shuffle_epi32(count, _MM_SHUFFLE(2, 3, 0, 1)));
+		return static_cast<std::size_t>(_mm_cvtsi128_si32(count));
+	}
+#endif
+
+	template <typename Key>
+	class BTreeIndex
+	{
+	public:
+		static constexpr std::size_t NodeBytes = 64;
+		static constexpr std::size_t SlotCount = NodeBytes / sizeof(Key);
+		static_assert(SlotCount >= 2, "keys too large for a 64-byte node");
+
+		// sorted must be in ascending order; the slots past the last key get PaddingKey
+		template <typename Policy>
+		BTreeIndex(Policy&& policy, const std::vector<Key>& sorted)
+			: size_(sorted.size()), nodeCount_((sorted.size() + SlotCount - 1) / SlotCount),
+			keys_(nodeCount_ * SlotCount), ranks_(nodeCount_ * SlotCount)
+		{
+			Key* keys = keys_.data();
+			std::uint32_t* ranks = ranks_.data();
+			const Key* source = sorted.data();
+			const std::size_t n = size_;
+			ForEachSlotRank<SlotCount>(std::forward<Policy>(policy), nodeCount_, [keys, ranks, source, n](std::size_t node, std::size_t slot, std::size_t rank) {
+				keys[node * SlotCount + slot] = rank < n ? source[rank] : PaddingKey<Key>();
+				ranks[node * SlotCount + slot] = static_cast<std::uint32_t>(std::min(rank, n));
+			});
+		}
+
+		std::size_t Size() const { return size_; }
+		std::size_t MemoryBytes() const { return keys_.size() * sizeof(Key) + ranks_.size() * sizeof(std::uint32_t); }
+
+		std::size_t LowerBound(Key key) const
+		{
+			std::size_t slot = keys_.size();
+			for (std::size_t node = 0; node < nodeCount_;)
+			{
+				const std::size_t less = CountLess<Key, SlotCount>(keys_.data() + node * SlotCount, key);
+				slot = less < SlotCount ? node * SlotCount + less : slot;
+				node = node * (SlotCount + 1) + 1 + less;
+			}
+			return slot < keys_.size() ? ranks_[slot] : size_;
+		}
+
+		// out[i] = LowerBound(queries[i])
+		template <typename Policy>
+		void LowerBounds(Policy&& policy, const Key* queries, std::size_t count, std::uint32_t* out) const
+		{
+			const std::size_t groups = (count + InterleavedQueries - 1) / InterleavedQueries;
+			algo::for_each(std::forward<Policy>(policy), pstl::counting_iterator<std::size_t>(0), pstl::counting_iterator<std::size_t>(groups),
+				[this, queries, count, out](std::size_t group) {
+				const std::size_t begin = group * InterleavedQueries;
+				const std::size_t size = std::min(InterleavedQueries, count - begin);
+				std::size_t node[InterleavedQueries], slot[InterleavedQueries];
+				std::fill(node, node + size, std::size_t(0));
+				std::fill(slot, slot + size, keys_.size());
+
+				for (bool searching = nodeCount_ > 0; searching;)
+				{
+					searching = false;
+					for (std::size_t q = 0; q < size; ++q)
+					{
+						if (node[q] >= nodeCount_)
+							continue;
+						const std::size_t less = CountLess<Key, SlotCount>(keys_.data() + node[q] * SlotCount, queries[begin + q]);
+						slot[q] = less < SlotCount ? node[q] * SlotCount + less : slot[q];
+						node[q] = node[q] * (SlotCount + 1) + 1 + less;
+						if (node[q] < nodeCount_)
+						{
+							PrefetchRead(keys_.data() + node[q] * SlotCount);
+							searching = true;
+						}
+					}
+				}
+				for (std::size_t q = 0; q < size; ++q)
+					out[begin + q] = static_cast<std::uint32_t>(slot[q] < keys_.size() ? ranks_[slot[q]] : size_);
+			});
+		}
+
+	private:
+		std::size_t size_;
+		std::size_t nodeCount_;
+		// 64-byte aligned, one node per cache line
+		columnar::Column<Key> keys_;
+		std::vector<std::uint32_t> ranks_;
+	};
+}
@@ -0,0 +1,134 @@
+﻿#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/execution>
+#include <pstl/iterators.h>
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+#include "AlgorithmDispatch.h"
+#include "RandomGen.h"
+
+// y = A * x with A in compressed sparse row form: for_each over the rows, a sequential
+// transform_reduce over each row's non-zeros. Same reduction as BM_DotProduct, but x is
+// gathered through the column indices and the rows have different lengths, so a static
+// split over the rows (threads_par) can end up badly balanced.
+//
+// Square n x n matrices with MeanNnzPerRow non-zeros per row on average:
+//	uniform   every row has MeanNnzPerRow entries
+//	powerlaw  Pareto distributed row lengths (alpha 2.5), a few rows are very long
+// Column indices are uniform random and sorted within a row.
+//
+// Counters: FLOP/s (2 per non-zero) and bytes_per_second, counting the matrix, the row
+// offsets, y and one x load per non-zero.
+
+enum class RowLengths { Uniform, PowerLaw };
+
+constexpr int MeanNnzPerRow = 16;
+
+struct CsrMatrix
+{
+	std::int64_t rows = 0;
+	std::vector<std::int64_t> rowStart; // rows + 1 entries
+	std::vector<std::int32_t> columns;
+	std::vector<double> values;
+};
+
+static std::int64_t GenRowLength(RowLengths lengths, std::int64_t cols)
+{
+	if (lengths == RowLengths::Uniform)
+		return std::min<std::int64_t>(MeanNnzPerRow, cols);
+
+	// Pareto with alpha = 2.5 has mean 3 * xmin
+	constexpr double Alpha = 2.5;
+	const double xmin = MeanNnzPerRow / 3.0;
+	const double u = GenRandomFloat(1.0e-6f, 1.0f);
+	const auto length = static_cast<std::int64_t>(xmin * std::pow(u, -1.0 / (Alpha - 1.0)));
+	return std::clamp<std::int64_t>(length, 1, cols);
+}
+
+static CsrMatrix GenRandomCsr(std::int64_t n, RowLengths lengths)
+{
+	CsrMatrix m;
+	m.rows = n;
+	m.rowStart.reserve(n + 1);
+	m.rowStart.push_back(0);
+	for (std::int64_t r = 0; r < n; ++r)
+		m.rowStart.push_back(m.rowStart.back() + GenRowLength(lengths, n));
+
+	const auto nnz = m.rowStart.back();
+	m.columns.resize(nnz);
+	m.values.resize(nnz);
+	for (std::int64_t r = 0; r < n; ++r)
+	{
+		const auto b = m.columns.begin() + m.rowStart[r], e = m.columns.begin() + m.rowStart[r + 1];
+		std::generate(b, e, [n]() { return GenRandomInt(0, static_cast<int>(n - 1)); });
+		std::sort(b, e);
+	}
+	std::generate(m.values.begin(), m.values.end(), []() { return GenRandomFloat(-1.0f, 1.0f); });
+	return m;
+}
+
+template <typename Policy>
+static void BM_SpMV(benchmark::State& state, RowLengths lengths, Policy execution_policy)
+{
+	const auto n = state.range(0);
+	const CsrMatrix a = GenRandomCsr(n, lengths);
+	std::vector<double> x(n), y(n);
+	std::generate(x.begin(), x.end(), []() { return GenRandomFloat(-1.0f, 1.0f); });
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		algo::for_each(execution_policy, pstl::counting_iterator<std::int64_t>(0), pstl::counting_iterator<std::int64_t>(n),
+			[&a, &x, &y](std::int64_t row) {
+			const auto b = a.rowStart[row], e = a.rowStart[row + 1];
+			y[row] = std::transform_reduce(a.values.begin() + b, a.values.begin() + e, a.columns.begin() + b, 0.0,
+				std::plus<double>(), [&x](double v, std::int32_t col) { return v * x[col]; });
+		});
+		benchmark::ClobberMemory();
+	}
+
+	const double nnz = static_cast<double>(a.values.size());
+	state.counters["FLOP"] = benchmark::Counter(2.0 * nnz, benchmark::Counter::kIsIterationInvariantRate);
+	state.counters["nnz/row"] = nnz / n;
+	const double bytes = nnz * (sizeof(double) + sizeof(std::int32_t) + sizeof(double))
+		+ (n + 1) * sizeof(std::int64_t) + n * sizeof(double);
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+
+// The row length distribution goes into the kernel name: BM_SpMV<powerlaw>/std_par/1000.
+template <typename Policy>
+static void RegisterSpMVBenchmark(const std::string& lengthsName, RowLengths lengths, const std::string& policyName, Policy policy)
+{
+	benchmark::RegisterBenchmark(("BM_SpMV<" + lengthsName + ">/" + policyName).c_str(),
+		[lengths, policy](benchmark::State& state) { BM_SpMV(state, lengths, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+}
+
+static void RegisterSpMVBenchmarks(const std::string& lengthsName, RowLengths lengths)
+{
+	RegisterSpMVBenchmark(lengthsName, lengths, "std_seq", std::execution::seq);
+	RegisterSpMVBenchmark(lengthsName, lengths, "std_par", std::execution::par);
+	RegisterSpMVBenchmark(lengthsName, lengths, "std_par_unseq", std::execution::par_unseq);
+	RegisterSpMVBenchmark(lengthsName, lengths, "pstl_seq", pstl::execution::seq);
+	RegisterSpMVBenchmark(lengthsName, lengths, "pstl_unseq", pstl::execution::unseq);
+	RegisterSpMVBenchmark(lengthsName, lengths, "pstl_par", pstl::execution::par);
+	RegisterSpMVBenchmark(lengthsName, lengths, "pstl_par_unseq", pstl::execution::par_unseq);
+	RegisterSpMVBenchmark(lengthsName, lengths, "threads_par", threaded::execution::par);
+}
+
+static const bool SpMVBenchmarksRegistered = []() {
+	RegisterSpMVBenchmarks("uniform", RowLengths::Uniform);
+	RegisterSpMVBenchmarks("powerlaw", RowLengths::PowerLaw);
+	return true;
+}();
@@ -0,0 +1,330 @@
+﻿#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/execution>
+#include <pstl/iterators.h>
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+#include "AlgorithmDispatch.h"
+#include "RandomGen.h"
+
+// Stencils over float and double grids: a 1D box blur with 3, 5 or 7 points and a
+// 2D 5-point Laplacian diffusion step (Jacobi). The boundary cells are fixed. One
+// benchmark iteration advances the grid by TimeSteps steps, in three ways:
+//	Naive     transform over counting_iterator cell indices, like BM_CountingIter,
+//	          one pass over the whole grid per step
+//	Blocked   for_each over blocks of cells (1D) or rows (2D), a plain inner loop per
+//	          block, one pass per step
+//	Temporal  for_each over blocks, every block copies itself plus a TimeSteps * radius
+//	          halo into a local buffer and does all the steps there, so the grid is
+//	          streamed from memory once per iteration instead of TimeSteps times;
+//	          seq and par policies only, see RegisterTemporalStencilBenchmarks
+// The interesting part is whether unseq / par_unseq vectorise the neighbour loads of
+// the naive version, and how much the blocked versions win over it.
+//
+// Counter: cells, grid cells updated per second (cells * TimeSteps per iteration).
+
+constexpr int TimeSteps = 4;
+constexpr std::int64_t BlockCells = 4096;
+constexpr std::int64_t BlockRows = 32;
+
+template <typename T>
+static std::vector<T> GenRandomGrid(std::int64_t cells)
+{
+	std::vector<T> grid(cells);
+	std::generate(grid.begin(), grid.end(), []() { return static_cast<T>(GenRandomFloat(0.0f, 1.0f)); });
+	return grid;
+}
+
+template <typename T, int Radius>
+static T Stencil1DPoint(const T* in, std::int64_t i)
+{
+	T sum = in[i];
+	for (int k = 1; k <= Radius; ++k)
+		sum += in[i - k] + in[i + k];
+	return sum * (T(1) / (2 * Radius + 1));
+}
+
+template <typename T>
+static T Laplace2DPoint(const T* in, std::int64_t i, std::int64_t n)
+{
+	return in[i] + T(0.2) * (in[i - n] + in[i + n] + in[i - 1] + in[i + 1] - T(4) * in[i]);
+}
+
+// Cells [first, last) of a local window [lo, hi) of [0, n) that are still valid after
+// step s of a temporally tiled block: the halo shrinks by radius every step, except at
+// the fixed grid boundary.
+static std::pair<std::int64_t, std::int64_t> ValidRange(std::int64_t lo, std::int64_t hi, std::int64_t n, std::int64_t radius, int step)
+{
+	return { lo == 0 ? radius : lo + step * radius, hi == n ? n - radius : hi - step * radius };
+}
+
+template <typename T, int Radius, typename Policy>
+static void BM_Stencil1DNaive(benchmark::State& state, Policy execution_policy)
+{
+	const auto n = state.range(0);
+	std::vector<T> cur = GenRandomGrid<T>(n), next(cur);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		for (int step = 0; step < TimeSteps; ++step)
+		{
+			const T* in = cur.data();
+			algo::transform(execution_policy, pstl::counting_iterator<std::int64_t>(Radius), pstl::counting_iterator<std::int64_t>(n - Radius),
+				next.begin() + Radius, [in](std::int64_t i) { return Stencil1DPoint<T, Radius>(in, i); });
+			std::swap(cur, next);
+		}
+		benchmark::ClobberMemory();
+	}
+	state.counters["cells"] = benchmark::Counter(static_cast<double>(n) * TimeSteps, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template <typename T, int Radius, typename Policy>
+static void BM_Stencil1DBlocked(benchmark::State& state, Policy execution_policy)
+{
+	const auto n = state.range(0);
+	std::vector<T> cur = GenRandomGrid<T>(n), next(cur);
+	const auto blocks = (n + BlockCells - 1) / BlockCells;
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		for (int step = 0; step < TimeSteps; ++step)
+		{
+			const T* in = cur.data();
+			T* out = next.data();
+			algo::for_each(execution_policy, pstl::counting_iterator<std::int64_t>(0), pstl::counting_iterator<std::int64_t>(blocks),
+				[in, out, n](std::int64_t block) {
+				const auto first = std::max<std::int64_t>(block * BlockCells, Radius);
+				const auto last = std::min<std::int64_t>((block + 1) * BlockCells, n - Radius);
+				for (std::int64_t i = first; i < last; ++i)
+					out[i] = Stencil1DPoint<T, Radius>(in, i);
+			});
+			std::swap(cur, next);
+		}
+		benchmark::ClobberMemory();
+	}
+	state.counters["cells"] = benchmark::Counter(static_cast<double>(n) * TimeSteps, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template <typename T, int Radius, typename Policy>
+static void BM_Stencil1DTemporal(benchmark::State& state, Policy execution_policy)
+{
+	const auto n = state.range(0);
+	std::vector<T> cur = GenRandomGrid<T>(n), next(cur);
+	const auto blocks = (n + BlockCells - 1) / BlockCells;
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		const T* in = cur.data();
+		T* out = next.data();
+		algo::for_each(execution_policy, pstl::counting_iterator<std::int64_t>(0), pstl::counting_iterator<std::int64_t>(blocks),
+			[in, out, n](std::int64_t block) {
+			const auto b = block * BlockCells, e = std::min((block + 1) * BlockCells, n);
+			const auto lo = std::max<std::int64_t>(b - TimeSteps * Radius, 0);
+			const auto hi = std::min<std::int64_t>(e + TimeSteps * Radius, n);
+
+			// per worker scratch holding cells [lo, hi)
+			thread_local std::vector<T> bufferA, bufferB;
+			bufferA.assign(in + lo, in + hi);
+			bufferB = bufferA;
+			T* src = bufferA.data();
+			T* dst = bufferB.data();
+			for (int step = 1; step <= TimeSteps; ++step)
+			{
+				const auto range = ValidRange(lo, hi, n, Radius, step);
+				for (std::int64_t i = range.first - lo; i < range.second - lo; ++i)
+					dst[i] = Stencil1DPoint<T, Radius>(src, i);
+				std::swap(src, dst);
+			}
+
+			for (std::int64_t i = std::max<std::int64_t>(b, Radius); i < std::min<std::int64_t>(e, n - Radius); ++i)
+				out[i] = src[i - lo];
+		});
+		std::swap(cur, next);
+		benchmark::ClobberMemory();
+	}
+	state.counters["cells"] = benchmark::Counter(static_cast<double>(n) * TimeSteps, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template <typename T, typename Policy>
+static void BM_Laplace2DNaive(benchmark::State& state, Policy execution_policy)
+{
+	const auto n = state.range(0);
+	std::vector<T> cur = GenRandomGrid<T>(n * n), next(cur);
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		for (int step = 0; step < TimeSteps; ++step)
+		{
+			const T* in = cur.data();
+			algo::transform(execution_policy, pstl::counting_iterator<std::int64_t>(n), pstl::counting_iterator<std::int64_t>(n * n - n),
+				next.begin() + n, [in, n](std::int64_t i) {
+				const auto col = i % n;
+				return (col == 0 || col == n - 1) ? in[i] : Laplace2DPoint(in, i, n);
+			});
+			std::swap(cur, next);
+		}
+		benchmark::ClobberMemory();
+	}
+	state.counters["cells"] = benchmark::Counter(static_cast<double>(n) * n * TimeSteps, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template <typename T, typename Policy>
+static void BM_Laplace2DBlocked(benchmark::State& state, Policy execution_policy)
+{
+	const auto n = state.range(0);
+	std::vector<T> cur = GenRandomGrid<T>(n * n), next(cur);
+	const auto blocks = (n + BlockRows - 1) / BlockRows;
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		for (int step = 0; step < TimeSteps; ++step)
+		{
+			const T* in = cur.data();
+			T* out = next.data();
+			algo::for_each(execution_policy, pstl::counting_iterator<std::int64_t>(0), pstl::counting_iterator<std::int64_t>(blocks),
+				[in, out, n](std::int64_t block) {
+				const auto first = std::max<std::int64_t>(block * BlockRows, 1);
+				const auto last = std::min<std::int64_t>((block + 1) * BlockRows, n - 1);
+				for (std::int64_t row = first; row < last; ++row)
+					for (std::int64_t i = row * n + 1; i < row * n + n - 1; ++i)
+						out[i] = Laplace2DPoint(in, i, n);
+			});
+			std::swap(cur, next);
+		}
+		benchmark::ClobberMemory();
+	}
+	state.counters["cells"] = benchmark::Counter(static_cast<double>(n) * n * TimeSteps, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template <typename T, typename Policy>
+static void BM_Laplace2DTemporal(benchmark::State& state, Policy execution_policy)
+{
+	const auto n = state.range(0);
+	std::vector<T> cur = GenRandomGrid<T>(n * n), next(cur);
+	const auto blocks = (n + BlockRows - 1) / BlockRows;
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		const T* in = cur.data();
+		T* out = next.data();
+		algo::for_each(execution_policy, pstl::counting_iterator<std::int64_t>(0), pstl::counting_iterator<std::int64_t>(blocks),
+			[in, out, n](std::int64_t block) {
+			const auto b = block * BlockRows, e = std::min((block + 1) * BlockRows, n);
+			const auto lo = std::max<std::int64_t>(b - TimeSteps, 0);
+			const auto hi = std::min<std::int64_t>(e + TimeSteps, n);
+
+			// per worker scratch holding rows [lo, hi)
+			thread_local std::vector<T> bufferA, bufferB;
+			bufferA.assign(in + lo * n, in + hi * n);
+			bufferB = bufferA;
+			T* src = bufferA.data();
+			T* dst = bufferB.data();
+			for (int step = 1; step <= TimeSteps; ++step)
+			{
+				const auto rows = ValidRange(lo, hi, n, 1, step);
+				for (std::int64_t row = rows.first - lo; row < rows.second - lo; ++row)
+					for (std::int64_t i = row * n + 1; i < row * n + n - 1; ++i)
+						dst[i] = Laplace2DPoint(src, i, n);
+				std::swap(src, dst);
+			}
+
+			for (std::int64_t row = std::max<std::int64_t>(b, 1); row < std::min<std::int64_t>(e, n - 1); ++row)
+				std::copy(src + (row - lo) * n + 1, src + (row - lo) * n + n - 1, out + row * n + 1);
+		});
+		std::swap(cur, next);
+		benchmark::ClobberMemory();
+	}
+	state.counters["cells"] = benchmark::Counter(static_cast<double>(n) * n * TimeSteps, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// Element type and stencil width go into the kernel name: BM_Stencil1DBlocked<float,5>/pstl_unseq/1000.
+template <typename T, typename Policy>
+static void RegisterStencilBenchmarks(const std::string& typeName, const std::string& policyName, Policy policy)
+{
+	const std::string suffix = "/" + policyName;
+	benchmark::RegisterBenchmark(("BM_Stencil1DNaive<" + typeName + ",3>" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_Stencil1DNaive<T, 1>(state, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_Stencil1DNaive<" + typeName + ",5>" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_Stencil1DNaive<T, 2>(state, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_Stencil1DNaive<" + typeName + ",7>" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_Stencil1DNaive<T, 3>(state, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_Stencil1DBlocked<" + typeName + ",3>" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_Stencil1DBlocked<T, 1>(state, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_Stencil1DBlocked<" + typeName + ",5>" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_Stencil1DBlocked<T, 2>(state, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_Stencil1DBlocked<" + typeName + ",7>" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_Stencil1DBlocked<T, 3>(state, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_Laplace2DNaive<" + typeName + ">" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_Laplace2DNaive<T>(state, policy); })
+		->RangeMultiplier(2)->Range(128, 2048)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_Laplace2DBlocked<" + typeName + ">" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_Laplace2DBlocked<T>(state, policy); })
+		->RangeMultiplier(2)->Range(128, 2048)->Unit(benchmark::kMicrosecond);
+}
+
+// The temporal kernels keep their block buffers in thread_local vectors that may
+// allocate, which is not allowed in an unsequenced element function: seq and par only.
+template <typename T, typename Policy>
+static void RegisterTemporalStencilBenchmarks(const std::string& typeName, const std::string& policyName, Policy policy)
+{
+	const std::string suffix = "/" + policyName;
+	benchmark::RegisterBenchmark(("BM_Stencil1DTemporal<" + typeName + ",3>" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_Stencil1DTemporal<T, 1>(state, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_Stencil1DTemporal<" + typeName + ",5>" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_Stencil1DTemporal<T, 2>(state, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_Stencil1DTemporal<" + typeName + ",7>" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_Stencil1DTemporal<T, 3>(state, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+
+	benchmark::RegisterBenchmark(("BM_Laplace2DTemporal<" + typeName + ">" + suffix).c_str(),
+		[policy](benchmark::State& state) { BM_Laplace2DTemporal<T>(state, policy); })
+		->RangeMultiplier(2)->Range(128, 2048)->Unit(benchmark::kMicrosecond);
+}
+
+template <typename T>
+static void RegisterStencilBenchmarks(const std::string& typeName)
+{
+	RegisterStencilBenchmarks<T>(typeName, "std_seq", std::execution::seq);
+	RegisterStencilBenchmarks<T>(typeName, "std_par", std::execution::par);
+	RegisterStencilBenchmarks<T>(typeName, "std_par_unseq", std::execution::par_unseq);
+	RegisterStencilBenchmarks<T>(typeName, "pstl_seq", pstl::execution::seq);
+	RegisterStencilBenchmarks<T>(typeName, "pstl_unseq", pstl::execution::unseq);
+	RegisterStencilBenchmarks<T>(typeName, "pstl_par", pstl::execution::par);
+	RegisterStencilBenchmarks<T>(typeName, "pstl_par_unseq", pstl::execution::par_unseq);
+	RegisterStencilBenchmarks<T>(typeName, "threads_par", threaded::execution::par);
+
+	RegisterTemporalStencilBenchmarks<T>(typeName, "std_seq", std::execution::seq);
+	RegisterTemporalStencilBenchmarks<T>(typeName, "std_par", std::execution::par);
+	RegisterTemporalStencilBenchmarks<T>(typeName, "pstl_seq", pstl::execution::seq);
+	RegisterTemporalStencilBenchmarks<T>(typeName, "pstl_par", pstl::execution::par);
+	RegisterTemporalStencilBenchmarks<T>(typeName, "threads_par", threaded::execution::par);
+}
+
+static const bool StencilBenchmarksRegistered = []() {
+	RegisterStencilBenchmarks<float>("float");
+	RegisterStencilBenchmarks<double>("double");
+	return true;
+}();
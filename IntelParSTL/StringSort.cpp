@@ -0,0 +1,208 @@
+﻿#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/execution>
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+#include "AlgorithmDispatch.h"
+#include "RandomGen.h"
+
+// Sorting N strings: pointer chasing and byte-wise compares instead of the flat keys
+// of BM_SortPoints. Three length distributions:
+//	short    4-15 chars, fits the small string buffer of MSVC, libstdc++ and libc++
+//	medium   16-64 chars, one heap block per string
+//	prefix   log-line like, one of a few 40+ char prefixes followed by 8-48 random
+//	         chars, so most compares walk the shared prefix first
+// and four variants: sort and stable_sort of std::string, sort of string_views into a
+// single arena, and sort of (8-byte big-endian prefix, view) keys that only look at
+// the text when the prefixes tie.
+//
+// Every iteration restores the unsorted input first; the copy is part of the timing.
+
+enum class StringLengths { Short, Medium, Prefix };
+
+static std::string GenRandomString(StringLengths lengths)
+{
+	static const char* const Prefixes[] = {
+		"2018-11-05T12:00:00Z worker-01 INFO  request id=",
+		"2018-11-05T12:00:00Z worker-01 WARN  request id=",
+		"2018-11-05T12:00:00Z worker-02 INFO  request id=",
+		"2018-11-05T12:00:01Z scheduler DEBUG task queued id=",
+	};
+
+	std::string text;
+	int length = 0;
+	switch (lengths)
+	{
+	case StringLengths::Short: length = GenRandomInt(4, 15); break;
+	case StringLengths::Medium: length = GenRandomInt(16, 64); break;
+	case StringLengths::Prefix:
+		text = Prefixes[GenRandomInt(0, 3)];
+		length = GenRandomInt(8, 48);
+		break;
+	}
+	for (int i = 0; i < length; ++i)
+		text += static_cast<char>(GenRandomInt('a', 'z'));
+	return text;
+}
+
+static std::vector<std::string> GenRandomStrings(std::size_t count, StringLengths lengths)
+{
+	std::vector<std::string> strings(count);
+	std::generate(strings.begin(), strings.end(), [lengths]() { return GenRandomString(lengths); });
+	return strings;
+}
+
+// All strings back to back in one buffer; the views stay valid as long as the arena lives.
+struct StringArena
+{
+	std::string buffer;
+	std::vector<std::string_view> views;
+
+	explicit StringArena(const std::vector<std::string>& strings)
+	{
+		std::size_t total = 0;
+		for (const auto& s : strings)
+			total += s.size();
+		buffer.reserve(total);
+		for (const auto& s : strings)
+			buffer += s;
+
+		views.reserve(strings.size());
+		std::size_t offset = 0;
+		for (const auto& s : strings)
+		{
+			views.emplace_back(buffer.data() + offset, s.size());
+			offset += s.size();
+		}
+	}
+};
+
+struct PrefixKey
+{
+	std::uint64_t prefix;
+	std::string_view text;
+};
+
+// First 8 bytes packed big-endian, so integer order equals byte order. Shorter strings
+// are zero padded; the tie-break on the full text sorts those out.
+static std::uint64_t MakePrefix(std::string_view text)
+{
+	std::uint64_t prefix = 0;
+	for (std::size_t i = 0; i < 8; ++i)
+		prefix = (prefix << 8) | (i < text.size() ? static_cast<unsigned char>(text[i]) : 0u);
+	return prefix;
+}
+
+template <typename Policy>
+static void BM_SortStrings(benchmark::State& state, StringLengths lengths, Policy execution_policy)
+{
+	const auto input = GenRandomStrings(state.range(0), lengths);
+	std::vector<std::string> strings(input.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::copy(input.begin(), input.end(), strings.begin());
+		algo::sort(execution_policy, strings.begin(), strings.end());
+		benchmark::ClobberMemory();
+	}
+}
+
+template <typename Policy>
+static void BM_StableSortStrings(benchmark::State& state, StringLengths lengths, Policy execution_policy)
+{
+	const auto input = GenRandomStrings(state.range(0), lengths);
+	std::vector<std::string> strings(input.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::copy(input.begin(), input.end(), strings.begin());
+		algo::stable_sort(execution_policy, strings.begin(), strings.end());
+		benchmark::ClobberMemory();
+	}
+}
+
+template <typename Policy>
+static void BM_SortStringViews(benchmark::State& state, StringLengths lengths, Policy execution_policy)
+{
+	const StringArena arena(GenRandomStrings(state.range(0), lengths));
+	std::vector<std::string_view> views(arena.views.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		std::copy(arena.views.begin(), arena.views.end(), views.begin());
+		algo::sort(execution_policy, views.begin(), views.end());
+		benchmark::ClobberMemory();
+	}
+}
+
+template <typename Policy>
+static void BM_SortPrefixKeys(benchmark::State& state, StringLengths lengths, Policy execution_policy)
+{
+	const StringArena arena(GenRandomStrings(state.range(0), lengths));
+	std::vector<PrefixKey> keys(arena.views.size());
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		// building the keys is part of the cost of this variant
+		algo::transform(execution_policy, arena.views.begin(), arena.views.end(), keys.begin(),
+			[](std::string_view text) { return PrefixKey{ MakePrefix(text), text }; });
+		algo::sort(execution_policy, keys.begin(), keys.end(),
+			[](const PrefixKey& a, const PrefixKey& b) {
+			if (a.prefix != b.prefix)
+				return a.prefix < b.prefix;
+			return a.text < b.text;
+		});
+		benchmark::ClobberMemory();
+	}
+}
+
+// The length distribution goes into the kernel name (BM_SortStrings<prefix>/std_par/1000)
+// so the reports keep the distributions apart.
+template <typename Policy>
+static void RegisterStringSortBenchmarks(const std::string& lengthsName, StringLengths lengths,
+	const std::string& policyName, Policy policy)
+{
+	const std::string suffix = "<" + lengthsName + ">/" + policyName;
+	benchmark::RegisterBenchmark(("BM_SortStrings" + suffix).c_str(),
+		[lengths, policy](benchmark::State& state) { BM_SortStrings(state, lengths, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_StableSortStrings" + suffix).c_str(),
+		[lengths, policy](benchmark::State& state) { BM_StableSortStrings(state, lengths, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_SortStringViews" + suffix).c_str(),
+		[lengths, policy](benchmark::State& state) { BM_SortStringViews(state, lengths, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+	benchmark::RegisterBenchmark(("BM_SortPrefixKeys" + suffix).c_str(),
+		[lengths, policy](benchmark::State& state) { BM_SortPrefixKeys(state, lengths, policy); })
+		->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+}
+
+// sort has no vectorised variant, so only seq and par like BM_SortPoints
+static void RegisterStringSortBenchmarks(const std::string& lengthsName, StringLengths lengths)
+{
+	RegisterStringSortBenchmarks(lengthsName, lengths, "std_seq", std::execution::seq);
+	RegisterStringSortBenchmarks(lengthsName, lengths, "std_par", std::execution::par);
+	RegisterStringSortBenchmarks(lengthsName, lengths, "pstl_seq", pstl::execution::seq);
+	RegisterStringSortBenchmarks(lengthsName, lengths, "pstl_par", pstl::execution::par);
+	RegisterStringSortBenchmarks(lengthsName, lengths, "threads_par", threaded::execution::par);
+}
+
+static const bool StringSortBenchmarksRegistered = []() {
+	RegisterStringSortBenchmarks("short", StringLengths::Short);
+	RegisterStringSortBenchmarks("medium", StringLengths::Medium);
+	RegisterStringSortBenchmarks("prefix", StringLengths::Prefix);
+	return true;
+}();
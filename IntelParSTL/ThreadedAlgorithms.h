@@ -0,0 +1,263 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "tbb/global_control.h"
+
+// Hand-rolled std::thread implementation of the algorithms used by the kernels, as a
+// third column next to std::execution and pstl::execution. Every call splits the range
+// into one contiguous chunk per worker, spawns the workers and joins them - no pool, no
+// work stealing, which is exactly what the library implementations are measured against.
+namespace threaded
+{
+	namespace execution
+	{
+		struct parallel_policy {};
+		constexpr parallel_policy par{};
+	}
+
+	template <typename T>
+	struct is_execution_policy : std::is_same<T, execution::parallel_policy> {};
+
+	template <typename T>
+	constexpr bool is_execution_policy_v = is_execution_policy<T>::value;
+
+	// chunks smaller than this are not worth a thread
+	constexpr std::ptrdiff_t MinChunkSize = 1024;
+
+	// Follows the driver's --threads limit (tbb::global_control) so all three
+	// implementations scale over the same worker counts.
+	inline std::ptrdiff_t WorkerCount()
+	{
+		return static_cast<std::ptrdiff_t>(tbb::global_control::active_value(tbb::global_control::max_allowed_parallelism));
+	}
+
+	inline std::ptrdiff_t ChunkCount(std::ptrdiff_t n)
+	{
+		return std::max<std::ptrdiff_t>(1, std::min(WorkerCount(), n / MinChunkSize));
+	}
+
+	// Calls body(chunk, begin, end) for every chunk of [0, n), the first chunk on the
+	// calling thread.
+	template <typename Body>
+	void ParallelChunks(std::ptrdiff_t n, std::ptrdiff_t chunks, Body body)
+	{
+		auto chunkBegin = [n, chunks](std::ptrdiff_t c) { return n * c / chunks; };
+
+		std::vector<std::thread> workers;
+		workers.reserve(chunks - 1);
+		for (std::ptrdiff_t c = 1; c < chunks; ++c)
+			workers.emplace_back(body, c, chunkBegin(c), chunkBegin(c + 1));
+		body(0, chunkBegin(0), chunkBegin(1));
+		for (auto& worker : workers)
+			worker.join();
+	}
+
+	template <typename RandomIt, typename Function>
+	void for_each(RandomIt first, RandomIt last, Function f)
+	{
+		const auto n = std::distance(first, last);
+		ParallelChunks(n, ChunkCount(n), [=](std::ptrdiff_t, std::ptrdiff_t b, std::ptrdiff_t e) {
+			std::for_each(first + b, first + e, f);
+		});
+	}
+
+	template <typename RandomIt, typename OutputIt, typename UnaryOp>
+	OutputIt transform(RandomIt first, RandomIt last, OutputIt out, UnaryOp op)
+	{
+		const auto n = std::distance(first, last);
+		ParallelChunks(n, ChunkCount(n), [=](std::ptrdiff_t, std::ptrdiff_t b, std::ptrdiff_t e) {
+			std::transform(first + b, first + e, out + b, op);
+		});
+		return out + n;
+	}
+
+	template <typename RandomIt1, typename RandomIt2, typename T, typename Reduce, typename Transform>
+	T transform_reduce(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, T init, Reduce reduce, Transform transform)
+	{
+		const auto n = std::distance(first1, last1);
+		const auto chunks = ChunkCount(n);
+		if (n == 0)
+			return init;
+
+		// one partial per chunk, seeded with the chunk's first element so no identity is needed
+		std::vector<T> partials(chunks);
+		ParallelChunks(n, chunks, [=, &partials](std::ptrdiff_t c, std::ptrdiff_t b, std::ptrdiff_t e) {
+			T acc = transform(first1[b], first2[b]);
+			for (std::ptrdiff_t i = b + 1; i < e; ++i)
+				acc = reduce(acc, transform(first1[i], first2[i]));
+			partials[c] = acc;
+		});
+		return std::accumulate(partials.begin(), partials.end(), init, reduce);
+	}
+
+	template <typename RandomIt, typename T, typename Reduce, typename Transform>
+	T transform_reduce(RandomIt first, RandomIt last, T init, Reduce reduce, Transform transform)
+	{
+		const auto n = std::distance(first, last);
+		const auto chunks = ChunkCount(n);
+		if (n == 0)
+			return init;
+
+		std::vector<T> partials(chunks);
+		ParallelChunks(n, chunks, [=, &partials](std::ptrdiff_t c, std::ptrdiff_t b, std::ptrdiff_t e) {
+			T acc = transform(first[b]);
+			for (std::ptrdiff_t i = b + 1; i < e; ++i)
+				acc = reduce(acc, transform(first[i]));
+			partials[c] = acc;
+		});
+		return std::accumulate(partials.begin(), partials.end(), init, reduce);
+	}
+
+	// Two passes: every chunk counts its matches, then every chunk copies them to the
+	// output behind the matches of the chunks in front of it.
+	template <typename RandomIt, typename OutputIt, typename UnaryPredicate>
+	OutputIt copy_if(RandomIt first, RandomIt last, OutputIt out, UnaryPredicate pred)
+	{
+		const auto n = std::distance(first, last);
+		const auto chunks = ChunkCount(n);
+
+		std::vector<std::ptrdiff_t> offsets(chunks + 1, 0);
+		ParallelChunks(n, chunks, [=, &offsets](std::ptrdiff_t c, std::ptrdiff_t b, std::ptrdiff_t e) {
+			offsets[c + 1] = std::count_if(first + b, first + e, pred);
+		});
+
+		std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+		ParallelChunks(n, chunks, [=, &offsets](std::ptrdiff_t c, std::ptrdiff_t b, std::ptrdiff_t e) {
+			std::copy_if(first + b, first + e, out + offsets[c], pred);
+		});
+		return out + offsets[chunks];
+	}
+
+	// Three passes: every chunk counts the elements that differ from their predecessor,
+	// copies them to a buffer behind those of the chunks in front of it, and the buffer
+	// is copied back over the front of the range (in place would overwrite elements
+	// another chunk still compares against).
+	template <typename RandomIt, typename BinaryPredicate>
+	RandomIt unique(RandomIt first, RandomIt last, BinaryPredicate equal)
+	{
+		using T = typename std::iterator_traits<RandomIt>::value_type;
+		const auto n = std::distance(first, last);
+		const auto chunks = ChunkCount(n);
+		auto kept = [first, equal](std::ptrdiff_t i) { return i == 0 || !equal(first[i - 1], first[i]); };
+
+		std::vector<std::ptrdiff_t> offsets(chunks + 1, 0);
+		ParallelChunks(n, chunks, [=, &offsets](std::ptrdiff_t c, std::ptrdiff_t b, std::ptrdiff_t e) {
+			std::ptrdiff_t count = 0;
+			for (std::ptrdiff_t i = b; i < e; ++i)
+				count += kept(i) ? 1 : 0;
+			offsets[c + 1] = count;
+		});
+
+		std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+		std::vector<T> buffer(offsets[chunks]);
+		ParallelChunks(n, chunks, [=, &offsets, &buffer](std::ptrdiff_t c, std::ptrdiff_t b, std::ptrdiff_t e) {
+			auto out = buffer.begin() + offsets[c];
+			for (std::ptrdiff_t i = b; i < e; ++i)
+			{
+				if (kept(i))
+					*out++ = first[i];
+			}
+		});
+
+		const auto size = static_cast<std::ptrdiff_t>(buffer.size());
+		ParallelChunks(size, ChunkCount(size), [=, &buffer](std::ptrdiff_t, std::ptrdiff_t b, std::ptrdiff_t e) {
+			std::move(buffer.begin() + b, buffer.begin() + e, first + b);
+		});
+		return first + size;
+	}
+
+	template <typename RandomIt>
+	RandomIt unique(RandomIt first, RandomIt last)
+	{
+		return threaded::unique(first, last, std::equal_to<>());
+	}
+
+	// Two passes: every chunk scans itself and keeps its total, then every chunk but the
+	// first adds the sum of the totals in front of it.
+	template <typename RandomIt, typename OutputIt, typename BinaryOp, typename UnaryOp>
+	OutputIt transform_inclusive_scan(RandomIt first, RandomIt last, OutputIt out, BinaryOp op, UnaryOp transform)
+	{
+		using T = std::decay_t<decltype(transform(*first))>;
+		const auto n = std::distance(first, last);
+		const auto chunks = ChunkCount(n);
+		if (n == 0)
+			return out;
+
+		std::vector<T> totals(chunks);
+		ParallelChunks(n, chunks, [=, &totals](std::ptrdiff_t c, std::ptrdiff_t b, std::ptrdiff_t e) {
+			T acc = transform(first[b]);
+			out[b] = acc;
+			for (std::ptrdiff_t i = b + 1; i < e; ++i)
+				out[i] = acc = op(acc, transform(first[i]));
+			totals[c] = acc;
+		});
+
+		std::partial_sum(totals.begin(), totals.end(), totals.begin(), op);
+		ParallelChunks(n, chunks, [=, &totals](std::ptrdiff_t c, std::ptrdiff_t b, std::ptrdiff_t e) {
+			if (c == 0)
+				return;
+			const T offset = totals[c - 1];
+			for (std::ptrdiff_t i = b; i < e; ++i)
+				out[i] = op(offset, out[i]);
+		});
+		return out + n;
+	}
+
+	// Sorts one chunk per worker with chunkSort, then merges neighbouring sorted runs
+	// pairwise, halving the run count every round. inplace_merge is stable, so the result
+	// is stable whenever chunkSort is.
+	template <typename RandomIt, typename Compare, typename ChunkSort>
+	void MergeSort(RandomIt first, RandomIt last, Compare comp, ChunkSort chunkSort)
+	{
+		const auto n = std::distance(first, last);
+		const auto chunks = ChunkCount(n);
+		auto chunkBegin = [n, chunks](std::ptrdiff_t c) { return n * std::min(c, chunks) / chunks; };
+
+		ParallelChunks(n, chunks, [=](std::ptrdiff_t, std::ptrdiff_t b, std::ptrdiff_t e) {
+			chunkSort(first + b, first + e, comp);
+		});
+
+		for (std::ptrdiff_t width = 1; width < chunks; width *= 2)
+		{
+			const std::ptrdiff_t pairs = (chunks + 2 * width - 1) / (2 * width);
+			ParallelChunks(pairs, pairs, [=](std::ptrdiff_t p, std::ptrdiff_t, std::ptrdiff_t) {
+				const auto lo = chunkBegin(2 * width * p);
+				const auto mid = chunkBegin(2 * width * p + width);
+				const auto hi = chunkBegin(2 * width * (p + 1));
+				std::inplace_merge(first + lo, first + mid, first + hi, comp);
+			});
+		}
+	}
+
+	template <typename RandomIt, typename Compare>
+	void sort(RandomIt first, RandomIt last, Compare comp)
+	{
+		MergeSort(first, last, comp, [](RandomIt b, RandomIt e, Compare c) { std::sort(b, e, c); });
+	}
+
+	template <typename RandomIt, typename Compare>
+	void stable_sort(RandomIt first, RandomIt last, Compare comp)
+	{
+		MergeSort(first, last, comp, [](RandomIt b, RandomIt e, Compare c) { std::stable_sort(b, e, c); });
+	}
+
+	template <typename RandomIt>
+	void sort(RandomIt first, RandomIt last)
+	{
+		threaded::sort(first, last, std::less<>());
+	}
+
+	template <typename RandomIt>
+	void stable_sort(RandomIt first, RandomIt last)
+	{
+		threaded::stable_sort(first, last, std::less<>());
+	}
+}
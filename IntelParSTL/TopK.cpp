@@ -0,0 +1,110 @@
+﻿#include <cstddef>
+#include <execution>
+#include <string>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/execution>
+
+#include "benchmark/benchmark.h"
+
+#include "../Common/CpuFrequency.h"
+
+#include "SalesData.h"
+#include "TopK.h"
+
+// Leaderboard query over the BM_CountingIter profit column: row indices of the k most
+// profitable sales (TopK.h), for k = 10, 1000 and 1% of the rows. A full sort of the
+// column is what all three avoid.
+//
+// Counter: rows, input rows scanned per second.
+
+// k as a row count, or as a percentage of the rows
+struct TopKSize
+{
+	std::size_t value;
+	bool percent;
+
+	std::size_t For(std::size_t rows) const { return percent ? rows * value / 100 : value; }
+	std::string Label() const { return std::to_string(value) + (percent ? "%" : ""); }
+};
+
+template <typename Policy>
+static void BM_TopKHeap(benchmark::State& state, TopKSize k, Policy execution_policy)
+{
+	const auto profit = GenProfit(state.range(0));
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		auto top = topk::Heap(execution_policy, profit, k.For(profit.size()));
+		benchmark::DoNotOptimize(top.data());
+	}
+	state.counters["rows"] = benchmark::Counter(static_cast<double>(profit.size()), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template <typename Policy>
+static void BM_TopKPartialSort(benchmark::State& state, TopKSize k, Policy execution_policy)
+{
+	const auto profit = GenProfit(state.range(0));
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		auto top = topk::PartialSort(execution_policy, profit, k.For(profit.size()));
+		benchmark::DoNotOptimize(top.data());
+	}
+	state.counters["rows"] = benchmark::Counter(static_cast<double>(profit.size()), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template <typename Policy>
+static void BM_TopKNthElement(benchmark::State& state, TopKSize k, Policy execution_policy)
+{
+	const auto profit = GenProfit(state.range(0));
+
+	CpuFrequencyMonitor frequencyMonitor(state);
+	for (auto _ : state)
+	{
+		auto top = topk::NthElement(execution_policy, profit, k.For(profit.size()));
+		benchmark::DoNotOptimize(top.data());
+	}
+	state.counters["rows"] = benchmark::Counter(static_cast<double>(profit.size()), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// k goes into the kernel name: BM_TopKHeap<1%>/pstl_par/1000000.
+template <typename Policy>
+static void RegisterTopKHeapBenchmark(TopKSize k, const std::string& policyName, Policy policy)
+{
+	benchmark::RegisterBenchmark(("BM_TopKHeap<" + k.Label() + ">/" + policyName).c_str(),
+		[k, policy](benchmark::State& state) { BM_TopKHeap(state, k, policy); })
+		->RangeMultiplier(10)->Range(100000, 10000000)->Unit(benchmark::kMillisecond);
+}
+
+template <typename Policy>
+static void RegisterTopKSortBenchmarks(TopKSize k, const std::string& policyName, Policy policy)
+{
+	RegisterTopKHeapBenchmark(k, policyName, policy);
+	benchmark::RegisterBenchmark(("BM_TopKPartialSort<" + k.Label() + ">/" + policyName).c_str(),
+		[k, policy](benchmark::State& state) { BM_TopKPartialSort(state, k, policy); })
+		->RangeMultiplier(10)->Range(100000, 10000000)->Unit(benchmark::kMillisecond);
+	benchmark::RegisterBenchmark(("BM_TopKNthElement<" + k.Label() + ">/" + policyName).c_str(),
+		[k, policy](benchmark::State& state) { BM_TopKNthElement(state, k, policy); })
+		->RangeMultiplier(10)->Range(100000, 10000000)->Unit(benchmark::kMillisecond);
+}
+
+// selection is not vectorisable, so seq and par only; partial_sort and nth_element
+// have no threaded:: version
+static void RegisterTopKBenchmarks(TopKSize k)
+{
+	RegisterTopKSortBenchmarks(k, "std_seq", std::execution::seq);
+	RegisterTopKSortBenchmarks(k, "std_par", std::execution::par);
+	RegisterTopKSortBenchmarks(k, "pstl_seq", pstl::execution::seq);
+	RegisterTopKSortBenchmarks(k, "pstl_par", pstl::execution::par);
+	RegisterTopKHeapBenchmark(k, "threads_par", threaded::execution::par);
+}
+
+static const bool TopKBenchmarksRegistered = []() {
+	for (TopKSize k : { TopKSize{ 10, false }, TopKSize{ 1000, false }, TopKSize{ 1, true } })
+		RegisterTopKBenchmarks(k);
+	return true;
+}();
@@ -0,0 +1,112 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <vector>
+
+#include <pstl/algorithm>
+#include <pstl/iterators.h>
+
+#include "AlgorithmDispatch.h"
+#include "BucketPartition.h"
+
+// Row indices of the k largest values of a column, largest first, in three ways:
+//	Heap         every chunk keeps a bounded heap of its k best rows in one pass, the
+//	             sorted heaps are merged at the end; O(n log k) with small k mostly
+//	             rejected by a single compare against the heap top
+//	PartialSort  partial_sort of all row indices
+//	NthElement   nth_element of all row indices, then a sort of the k in front
+// Ties go to the lower row index, so all three return the same rows. Only Heap has a
+// threaded:: version; the other two take std:: and pstl:: policies.
+namespace topk
+{
+	using RowIndex = std::uint32_t;
+
+	// true when row a ranks above row b
+	class RanksBefore
+	{
+	public:
+		explicit RanksBefore(const double* values) : values_(values) {}
+
+		bool operator()(RowIndex a, RowIndex b) const
+		{
+			return values_[a] > values_[b] || (values_[a] == values_[b] && a < b);
+		}
+
+	private:
+		const double* values_;
+	};
+
+	template <typename Policy>
+	std::vector<RowIndex> Heap(Policy&& policy, const std::vector<double>& values, std::size_t k)
+	{
+		const auto n = static_cast<std::ptrdiff_t>(values.size());
+		k = std::min(k, values.size());
+		const auto chunks = algo::IsSequential<Policy> ? 1 : threaded::ChunkCount(n);
+		const RanksBefore before(values.data());
+
+		// the heap top is the worst row kept so far; sorted best first afterwards
+		std::vector<std::vector<RowIndex>> heaps(chunks);
+		bucket::ForEachChunk(policy, chunks, [&](std::ptrdiff_t c) {
+			auto& heap = heaps[c];
+			heap.reserve(k);
+			for (auto i = static_cast<RowIndex>(n * c / chunks); i < n * (c + 1) / chunks; ++i)
+			{
+				if (heap.size() < k)
+				{
+					heap.push_back(i);
+					std::push_heap(heap.begin(), heap.end(), before);
+				}
+				else if (k > 0 && before(i, heap.front()))
+				{
+					std::pop_heap(heap.begin(), heap.end(), before);
+					heap.back() = i;
+					std::push_heap(heap.begin(), heap.end(), before);
+				}
+			}
+			std::sort_heap(heap.begin(), heap.end(), before);
+		});
+
+		// k-way merge of the chunk heads, there are only as many chunks as workers
+		std::vector<RowIndex> top;
+		top.reserve(k);
+		std::vector<std::size_t> heads(chunks, 0);
+		while (top.size() < k)
+		{
+			std::ptrdiff_t best = -1;
+			for (std::ptrdiff_t c = 0; c < chunks; ++c)
+			{
+				if (heads[c] < heaps[c].size() && (best < 0 || before(heaps[c][heads[c]], heaps[best][heads[best]])))
+					best = c;
+			}
+			top.push_back(heaps[best][heads[best]++]);
+		}
+		return top;
+	}
+
+	template <typename Policy>
+	std::vector<RowIndex> PartialSort(Policy&& policy, const std::vector<double>& values, std::size_t k)
+	{
+		k = std::min(k, values.size());
+		std::vector<RowIndex> rows(values.size());
+		std::copy(policy, pstl::counting_iterator<RowIndex>(0), pstl::counting_iterator<RowIndex>(static_cast<RowIndex>(rows.size())), rows.begin());
+		std::partial_sort(policy, rows.begin(), rows.begin() + k, rows.end(), RanksBefore(values.data()));
+		rows.resize(k);
+		return rows;
+	}
+
+	template <typename Policy>
+	std::vector<RowIndex> NthElement(Policy&& policy, const std::vector<double>& values, std::size_t k)
+	{
+		k = std::min(k, values.size());
+		std::vector<RowIndex> rows(values.size());
+		std::copy(policy, pstl::counting_iterator<RowIndex>(0), pstl::counting_iterator<RowIndex>(static_cast<RowIndex>(rows.size())), rows.begin());
+		if (k < rows.size())
+			std::nth_element(policy, rows.begin(), rows.begin() + k, rows.end(), RanksBefore(values.data()));
+		std::sort(policy, rows.begin(), rows.begin() + k, RanksBefore(values.data()));
+		rows.resize(k);
+		return rows;
+	}
+}